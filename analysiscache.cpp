@@ -0,0 +1,106 @@
+#include "analysiscache.h"
+#include "analyzer.h"
+
+#include <cstring>
+
+AnalysisCache::AnalysisCache(size_t memoryLimit)
+    : limit(memoryLimit)
+{
+}
+
+size_t AnalysisCache::footprint(const AnalysisResult &result)
+{
+    return sizeof(AnalysisResult) + result.samples->memoryUsage() +
+           result.spectrum.capacity() * sizeof(std::complex<double>) + result.pyramid.memoryUsage() +
+           result.spectrogram.levels.capacity() * sizeof(float) + result.psd.capacity() * sizeof(double) +
+           result.tones.capacity() * sizeof(ToneMeasurement) + result.response.capacity() * sizeof(double);
+}
+
+quint64 AnalysisCache::key(const Signal &signal, const AnalysisSettings &settings)
+{
+    quint64 hash = signal.contentHash();
+    const FilterSpec &filter = settings.filter;
+    quint64 low, high;
+    std::memcpy(&low, &filter.low, sizeof low);
+    std::memcpy(&high, &filter.high, sizeof high);
+    for (quint64 value : {static_cast<quint64>(settings.window), static_cast<quint64>(settings.frameSize),
+                          static_cast<quint64>(settings.hop), static_cast<quint64>(filter.design),
+                          static_cast<quint64>(filter.type), low, high, static_cast<quint64>(filter.order)})
+        hash = (hash ^ (value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2))) * 1099511628211ull;
+    return hash;
+}
+
+std::list<AnalysisCache::Entry>::const_iterator AnalysisCache::lookup(const Signal &signal,
+                                                                      const AnalysisSettings &settings) const
+{
+    auto it = index.find(key(signal, settings));
+    // A hash collision is a miss too
+    if (it == index.end() || it->second->result->settings != settings ||
+        !it->second->result->signal.sameContent(signal))
+        return entries.end();
+    return it->second;
+}
+
+std::shared_ptr<const AnalysisResult> AnalysisCache::find(const Signal &signal, const AnalysisSettings &settings)
+{
+    auto entry = lookup(signal, settings);
+    if (entry == entries.end())
+    {
+        missCount++;
+        return nullptr;
+    }
+
+    hitCount++;
+    entries.splice(entries.begin(), entries, entry);
+    return entry->result;
+}
+
+bool AnalysisCache::contains(const Signal &signal, const AnalysisSettings &settings) const
+{
+    return lookup(signal, settings) != entries.end();
+}
+
+void AnalysisCache::insert(std::shared_ptr<const AnalysisResult> result)
+{
+    if (!result)
+        return;
+
+    quint64 hash = key(result->signal, result->settings);
+    auto it = index.find(hash);
+    if (it != index.end())
+    {
+        usage -= it->second->bytes;
+        entries.erase(it->second);
+        index.erase(it);
+    }
+
+    size_t bytes = footprint(*result);
+    entries.push_front(Entry{hash, std::move(result), bytes});
+    index[hash] = entries.begin();
+    usage += bytes;
+    evict();
+}
+
+void AnalysisCache::clear()
+{
+    entries.clear();
+    index.clear();
+    usage = 0;
+}
+
+void AnalysisCache::setMemoryLimit(size_t bytes)
+{
+    limit = bytes;
+    evict();
+}
+
+void AnalysisCache::evict()
+{
+    while (usage > limit && entries.size() > 1)
+    {
+        const Entry &oldest = entries.back();
+        usage -= oldest.bytes;
+        index.erase(oldest.hash);
+        entries.pop_back();
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef ANALYSISCACHE_H
+#define ANALYSISCACHE_H
+#include <QtGlobal>
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+#include "window.h"
+#include "filter.h"
+
+struct AnalysisResult;
+struct Signal;
+
+// What an analysis depends on besides the signal
+struct AnalysisSettings
+{
+    WindowType window = WindowType::Hann; // DFT, STFT frames and Welch segments
+    size_t frameSize = 2048;              // STFT frame and Welch segment length in samples
+    size_t hop = 512;                     // Step between them in samples
+    FilterSpec filter;                    // Applied to the samples before everything else
+
+    bool operator==(const AnalysisSettings &other) const
+    {
+        return window == other.window && frameSize == other.frameSize && hop == other.hop &&
+               filter == other.filter;
+    }
+    bool operator!=(const AnalysisSettings &other) const { return !(*this == other); }
+};
+
+// Least-recently-used cache of analysis results, keyed by Signal::contentHash and the AnalysisSettings.
+// Signals with the same sampling and overtone parameters share one entry whatever their
+// names, and an edit that changes nothing relevant still finds its samples and spectrum.
+// The oldest entries are evicted once the results exceed the memory limit. The result
+// used last always stays, even if it is larger than the limit alone.
+// Not thread-safe, SignalAnalyzer uses it from its own thread only.
+class AnalysisCache
+{
+public:
+    explicit AnalysisCache(size_t memoryLimit = 256 * 1024 * 1024);
+
+    // Cached result for the content of signal, nullptr if there is none (counted as a miss)
+    std::shared_ptr<const AnalysisResult> find(const Signal &signal, const AnalysisSettings &settings);
+
+    // Whether find() would hit, without counting or touching the entry
+    bool contains(const Signal &signal, const AnalysisSettings &settings) const;
+
+    // Add a result, or refresh the entry of the same content
+    void insert(std::shared_ptr<const AnalysisResult> result);
+
+    void clear();
+
+    void setMemoryLimit(size_t bytes);
+    size_t memoryLimit() const { return limit; }
+    // Bytes held by the cached results
+    size_t memoryUsage() const { return usage; }
+    size_t size() const { return entries.size(); }
+
+    quint64 hits() const { return hitCount; }
+    quint64 misses() const { return missCount; }
+
+    // Bytes held by one result
+    static size_t footprint(const AnalysisResult &result);
+
+private:
+    struct Entry
+    {
+        quint64 hash;
+        std::shared_ptr<const AnalysisResult> result;
+        size_t bytes;
+    };
+
+    static quint64 key(const Signal &signal, const AnalysisSettings &settings);
+    // The entry of key, if it holds signal analysed with window
+    std::list<Entry>::const_iterator lookup(const Signal &signal, const AnalysisSettings &settings) const;
+    void evict();
+
+    std::list<Entry> entries; // Most recently used first
+    std::unordered_map<quint64, std::list<Entry>::iterator> index;
+    size_t limit;
+    size_t usage = 0;
+    quint64 hitCount = 0;
+    quint64 missCount = 0;
+};
+
+#endif // ANALYSISCACHE_H
@@ -0,0 +1,206 @@
+#include "analyzer.h"
+#include "spectrum.h"
+#include "welch.h"
+
+#include <QtConcurrent/QtConcurrent>
+#include <QMetaObject>
+
+#include <algorithm>
+
+namespace
+{
+
+// Points of the plotted filter response
+constexpr size_t RESPONSE_POINTS = 2048;
+
+} // namespace
+
+SignalAnalyzer::SignalAnalyzer(QObject *parent)
+    : QObject(parent)
+{
+}
+
+SignalAnalyzer::~SignalAnalyzer()
+{
+    if (currentToken)
+        *currentToken = true;
+    for (QFuture<void> &job : jobs)
+        job.waitForFinished();
+}
+
+void SignalAnalyzer::analyze(const Signal &signal)
+{
+    // Stop the previous job, its results would be stale anyway
+    if (currentToken)
+        *currentToken = true;
+
+    quint64 id = ++currentId;
+
+    // Same content analysed before: delivered as if the job finished at once
+    if (std::shared_ptr<const AnalysisResult> hit = resultCache.find(signal, analysisSettings))
+    {
+        currentToken.reset();
+        // The cached result may come from an identical signal with another name
+        if (hit->signal.name != signal.name)
+        {
+            AnalysisResult renamed = *hit;
+            renamed.signal = signal;
+            hit = std::make_shared<const AnalysisResult>(std::move(renamed));
+        }
+
+        QMetaObject::invokeMethod(this, [this, id, hit] {
+            if (id != currentId)
+                return;
+            emit progress(100);
+            emit finished(hit);
+        }, Qt::QueuedConnection);
+        return;
+    }
+
+    Token token = std::make_shared<std::atomic<bool>>(false);
+    currentToken = token;
+
+    // Forget the jobs that are already over
+    jobs.erase(std::remove_if(jobs.begin(), jobs.end(),
+                              [](const QFuture<void> &job) { return job.isFinished(); }),
+               jobs.end());
+
+    Signal snapshot = signal;
+    AnalysisSettings settings = analysisSettings;
+    jobs.append(QtConcurrent::run([this, snapshot, settings, id, token] { run(snapshot, settings, id, token); }));
+}
+
+void SignalAnalyzer::cancel()
+{
+    if (!currentToken)
+        return;
+
+    *currentToken = true;
+    currentToken.reset();
+    currentId++; // Drop whatever the cancelled job has already queued
+    emit cancelled();
+}
+
+// Worker thread
+void SignalAnalyzer::run(Signal signal, AnalysisSettings settings, quint64 id, Token token)
+{
+    size_t count = signal.getSampleCount();
+
+    // Recordings are read from their source as each step goes; synthesized (or filtered)
+    // samples are computed once into memory
+    std::shared_ptr<const SampleSource> samples = signal.source;
+    Filter filter(settings.filter, signal.sampleRate);
+    if (!samples || settings.filter.design != FilterDesign::None)
+    {
+        auto buffer = std::make_shared<std::vector<double>>(count);
+
+        // Sample in chunks so that the job can stop early and report progress (0..60%)
+        const size_t chunk = std::max<size_t>(count / 50, 4096);
+        for (size_t begin = 0; begin < count; begin += chunk)
+        {
+            if (*token)
+                return;
+            size_t end = std::min(count, begin + chunk);
+            signal.getSamples(begin, end, buffer->data() + begin);
+            reportProgress(id, static_cast<int>(60 * end / count));
+        }
+
+        // Everything below sees the filtered signal
+        if (*token)
+            return;
+        if (settings.filter.design != FilterDesign::None)
+        {
+            auto filtered = std::make_shared<std::vector<double>>(count);
+            filter.apply(buffer->data(), filtered->data(), count, token.get());
+            if (*token)
+                return;
+            buffer = std::move(filtered);
+        }
+        samples = std::make_shared<BufferSource>(std::move(buffer), signal.sampleRate);
+    }
+    std::vector<double> response = filter.responseDb(RESPONSE_POINTS);
+    double responseStep = 0.5 * signal.sampleRate / (RESPONSE_POINTS - 1);
+
+    if (*token)
+        return;
+    MinMaxPyramid pyramid;
+    pyramid.build(*samples);
+
+    // The DFT covers the first second only
+    if (*token)
+        return;
+    size_t length = signal.getDFTWindowLength();
+    std::vector<double> head(length);
+    samples->read(0, length, head.data());
+    std::vector<std::complex<double>> spectrum = signal.getRealDFT(std::move(head), settings.window);
+    reportProgress(id, 70);
+
+    double amplitudeScale = sineAmplitudeScale(length, settings.window);
+
+    // Frames run on the shared pool, the token stops them early
+    if (*token)
+        return;
+    Spectrogram spectrogram = stft(*samples, settings.frameSize, settings.hop, settings.window, token.get());
+    if (*token)
+        return;
+    reportProgress(id, 90);
+
+    // Segments shortened to the signal if it is shorter than a frame
+    size_t segmentSize = std::min(settings.frameSize, count);
+    std::vector<double> psd;
+    double psdBinWidth = 0.0;
+    if (segmentSize > 0)
+    {
+        WelchEstimator welch(segmentSize, std::min(settings.hop, segmentSize), settings.window, signal.sampleRate);
+        std::vector<double> chunk(std::min<size_t>(count, 65536));
+        for (size_t begin = 0; begin < count; begin += chunk.size())
+        {
+            if (*token)
+                return;
+            size_t end = std::min(count, begin + chunk.size());
+            samples->read(begin, end, chunk.data());
+            // Checks the token before every segment
+            welch.add(chunk.data(), end - begin, token.get());
+        }
+        if (*token)
+            return;
+        psd = powerToDb(welch.psd(), -200.0); // About the rounding noise of the FFT
+        psdBinWidth = welch.binWidth();
+    }
+
+    // Only the configured frequencies, cheaper than another spectrum of the whole signal.
+    // Recordings have no overtones to measure
+    if (*token)
+        return;
+    std::vector<ToneMeasurement> tones;
+    if (samples->data())
+    {
+        std::vector<double> frequencies;
+        for (const overtone &ot : signal.overtones)
+            frequencies.push_back(ot.frequency);
+        tones = measureTones(samples->data(), count, signal.sampleRate, frequencies);
+    }
+
+    auto result = std::make_shared<const AnalysisResult>(
+        AnalysisResult{std::move(signal), std::move(samples), std::move(spectrum), std::move(pyramid),
+                       std::move(spectrogram), std::move(psd), psdBinWidth, std::move(tones),
+                       std::move(response), responseStep, settings, amplitudeScale});
+
+    QMetaObject::invokeMethod(this, [this, id, result] {
+        if (id != currentId)
+            return;
+        currentToken.reset();
+        resultCache.insert(result);
+        emit progress(100);
+        emit finished(result);
+    }, Qt::QueuedConnection);
+}
+
+// Worker thread
+void SignalAnalyzer::reportProgress(quint64 id, int percent)
+{
+    QMetaObject::invokeMethod(this, [this, id, percent] {
+        if (id == currentId)
+            emit progress(percent);
+    }, Qt::QueuedConnection);
+}
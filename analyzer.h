@@ -0,0 +1,87 @@
+#ifndef ANALYZER_H
+#define ANALYZER_H
+#include <QObject>
+#include <QFuture>
+#include <QList>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <complex>
+
+#include "signal.h"
+#include "pyramid.h"
+#include "analysiscache.h"
+#include "stft.h"
+#include "goertzel.h"
+
+// Samples, spectrum, spectrogram, PSD and overtone levels of one Signal snapshot,
+// after the filter of the settings if there is one.
+// Results are immutable: a changed Signal gets a new result, with its own pyramid
+struct AnalysisResult
+{
+    Signal signal;                                   // Parameters the result was computed from
+    std::shared_ptr<const SampleSource> samples;     // Signal::getSamples, filtered: the signal's
+                                                     // source itself for an unfiltered recording
+    std::vector<std::complex<double>> spectrum;      // Signal::getRealDFT
+    MinMaxPyramid pyramid;                           // Over samples, for zooming the chart
+    Spectrogram spectrogram;                         // STFT of samples
+    std::vector<double> psd;                         // Welch PSD of samples in dB (units^2/Hz)
+    double psdBinWidth = 0.0;                        // Hz between psd bins
+    std::vector<ToneMeasurement> tones;              // Measured at each overtone's frequency
+    std::vector<double> response;                    // |H| of the filter in dB from 0 to Nyquist
+    double responseStep = 0.0;                       // Hz between response points
+    AnalysisSettings settings;                       // Window, STFT frames and Welch segments
+    double amplitudeScale = 0.0;                     // |spectrum[k]| * amplitudeScale is the amplitude
+                                                     // of a sine in bin k, corrected for the window's
+                                                     // coherent gain (half that at DC and Nyquist)
+};
+
+// Computes samples, spectrum and spectrogram of a signal off the GUI thread.
+// analyze() snapshots the signal and runs the work with QtConcurrent; progress and the
+// result come back through queued calls, so the slots connected to progress() and
+// finished() always run on the analyzer's thread. Only the latest request matters:
+// starting a new one or calling cancel() stops the job in flight at its next checkpoint
+// and drops whatever it would have delivered. Finished results are kept in an AnalysisCache,
+// a signal whose content was analysed before is delivered from there without recomputing.
+class SignalAnalyzer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SignalAnalyzer(QObject *parent = nullptr);
+    // Cancel and wait for the jobs still running
+    ~SignalAnalyzer();
+
+    // Start analysing a copy of signal, cancelling the previous job
+    void analyze(const Signal &signal);
+
+    // Cancel the job in flight, if any
+    void cancel();
+
+    // Window and STFT frames of the next analyses
+    void setSettings(const AnalysisSettings &settings) { analysisSettings = settings; }
+    const AnalysisSettings &settings() const { return analysisSettings; }
+
+    // Results of previous analyses
+    AnalysisCache &cache() { return resultCache; }
+
+signals:
+    // Percentage of the current job
+    void progress(int percent);
+    void finished(std::shared_ptr<const AnalysisResult> result);
+    void cancelled();
+
+private:
+    using Token = std::shared_ptr<std::atomic<bool>>;
+
+    void run(Signal signal, AnalysisSettings settings, quint64 id, Token token);
+    void reportProgress(quint64 id, int percent);
+
+    AnalysisSettings analysisSettings;
+    AnalysisCache resultCache;
+    quint64 currentId = 0;
+    Token currentToken;
+    QList<QFuture<void>> jobs;
+};
+
+#endif // ANALYZER_H
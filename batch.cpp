@@ -0,0 +1,316 @@
+// Headless batch analysis: synthesizes every signal of a signals file (same schema as
+// data.json) and writes its samples and spectra, all signals at once on the shared pool.
+//
+//   elkavolk-batch [options] signals.json
+//
+// Per signal <nn>-<name> (nn its position in the file) the output directory gets
+//   .samples        the samples over the duration
+//   .spectrum       DFT of the first second: frequency, amplitude, phase (rectangular window)
+//   .spectrum-<w>   the same with --window w
+//   .psd            Welch PSD in dB with --welch
+// as .csv, or with --format binary as .f64: little-endian doubles, the samples one per value,
+// the spectra as (frequency, amplitude, phase) triples and the PSD as (frequency, dB) pairs.
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "signal.h"
+#include "spectrum.h"
+#include "threadpool.h"
+#include "utils.h"
+#include "welch.h"
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+double millisecondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+struct Options
+{
+    QDir output;
+    bool binary = false;
+    bool samples = true;
+    bool windowed = false;
+    WindowType window = WindowType::Hann;
+    QString windowName;
+    size_t welchSegment = 0; // 0 = no PSD
+};
+
+// One signal's work and how long each part took
+struct Job
+{
+    Signal signal;
+    QString base; // Output file name without extension
+    size_t sampleCount = 0;
+    double synthesisMs = 0.0;
+    double spectrumMs = 0.0;
+    double welchMs = 0.0;
+    double writeMs = 0.0;
+    QString error;
+};
+
+bool parseWindow(const QString &name, WindowType &window)
+{
+    static const std::pair<const char *, WindowType> names[] = {
+        {"rectangular", WindowType::Rectangular}, {"hann", WindowType::Hann},
+        {"hamming", WindowType::Hamming},         {"blackman-harris", WindowType::BlackmanHarris},
+        {"kaiser", WindowType::Kaiser}};
+    for (const auto &entry : names)
+    {
+        if (name.compare(entry.first, Qt::CaseInsensitive) == 0)
+        {
+            window = entry.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Writes rows of columns values each, as CSV under a header or as raw doubles
+class Table
+{
+public:
+    Table(const Options &options, const QString &path, const char *header, size_t columns)
+        : binary(options.binary), columns(columns)
+    {
+        file = std::fopen(QFile::encodeName(path + (binary ? ".f64" : ".csv")).constData(), binary ? "wb" : "w");
+        if (file && !binary)
+            std::fprintf(file, "%s\n", header);
+    }
+    ~Table()
+    {
+        if (file)
+            std::fclose(file);
+    }
+
+    bool isOpen() const { return file != nullptr; }
+
+    void row(const double *values)
+    {
+        if (binary)
+        {
+            std::fwrite(values, sizeof(double), columns, file);
+            return;
+        }
+        for (size_t i = 0; i < columns; i++)
+            std::fprintf(file, i + 1 < columns ? "%.17g," : "%.17g\n", values[i]);
+    }
+
+private:
+    std::FILE *file = nullptr;
+    bool binary;
+    size_t columns;
+};
+
+// File name from a signal name, anything unusual replaced
+QString fileName(int index, const QString &name)
+{
+    QString safe;
+    for (QChar c : name)
+        safe += c.isLetterOrNumber() || c == '-' || c == '_' ? c : QChar('_');
+    return QString("%1-%2").arg(index + 1, 2, 10, QChar('0')).arg(safe);
+}
+
+bool writeSpectrum(const Options &options, const QString &path, const Signal &signal,
+                   const std::vector<std::complex<double>> &spectrum, WindowType window)
+{
+    Table table(options, path, "frequency,amplitude,phase", 3);
+    if (!table.isOpen())
+        return false;
+
+    // Sine amplitudes, corrected for the window like the chart; bins are 1 Hz apart
+    double scale = sineAmplitudeScale(signal.getDFTWindowLength(), window);
+    std::vector<double> amplitudes = sineAmplitudes(spectrum, static_cast<size_t>(signal.sampleRate), scale);
+    for (size_t k = 0; k < spectrum.size(); k++)
+    {
+        double values[3] = {static_cast<double>(k), amplitudes[k], std::arg(spectrum[k])};
+        table.row(values);
+    }
+    return true;
+}
+
+void run(Job &job, const Options &options)
+{
+    const Signal &signal = job.signal;
+    const QString path = options.output.filePath(job.base);
+
+    Clock::time_point start = Clock::now();
+    std::vector<double> samples = signal.getSamples();
+    job.sampleCount = samples.size();
+    job.synthesisMs = millisecondsSince(start);
+
+    start = Clock::now();
+    std::vector<std::complex<double>> spectrum = signal.getRealDFT(samples);
+    std::vector<std::complex<double>> windowed;
+    if (options.windowed)
+        windowed = signal.getRealDFT(samples, options.window);
+    job.spectrumMs = millisecondsSince(start);
+
+    std::vector<double> psd;
+    double binWidth = 0.0;
+    if (options.welchSegment > 0 && !samples.empty())
+    {
+        start = Clock::now();
+        size_t segment = std::min(options.welchSegment, samples.size());
+        WelchEstimator welch(segment, segment / 4 > 0 ? segment / 4 : 1, options.window, signal.sampleRate);
+        welch.add(samples.data(), samples.size());
+        psd = powerToDb(welch.psd(), -200.0);
+        binWidth = welch.binWidth();
+        job.welchMs = millisecondsSince(start);
+    }
+
+    start = Clock::now();
+    bool written = true;
+    if (options.samples)
+    {
+        // Binary files hold the values only
+        Table table(options, path + ".samples", "time,value", options.binary ? 1 : 2);
+        written = written && table.isOpen();
+        for (size_t i = 0; table.isOpen() && i < samples.size(); i++)
+        {
+            double values[2] = {static_cast<double>(i) / signal.sampleRate, samples[i]};
+            table.row(options.binary ? values + 1 : values);
+        }
+    }
+    written = written && writeSpectrum(options, path + ".spectrum", signal, spectrum, WindowType::Rectangular);
+    if (options.windowed)
+        written = written && writeSpectrum(options, path + ".spectrum-" + options.windowName, signal, windowed,
+                                           options.window);
+    if (!psd.empty())
+    {
+        Table table(options, path + ".psd", "frequency,psd_db", 2);
+        written = written && table.isOpen();
+        for (size_t k = 0; table.isOpen() && k < psd.size(); k++)
+        {
+            double values[2] = {k * binWidth, psd[k]};
+            table.row(values);
+        }
+    }
+    job.writeMs = millisecondsSince(start);
+    if (!written)
+        job.error = "cannot write to " + options.output.path();
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("elkavolk-batch");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Synthesize and analyse every signal of a signals file");
+    parser.addHelpOption();
+    parser.addPositionalArgument("signals", "JSON file with a \"signals\" array, like data.json");
+    QCommandLineOption outputOption({"o", "output"}, "Directory for the results (default: current).", "dir", ".");
+    QCommandLineOption formatOption({"f", "format"}, "csv or binary (raw little-endian doubles).", "format", "csv");
+    QCommandLineOption windowOption({"w", "window"},
+                                    "Also write the spectrum under this window: rectangular, hann, hamming, "
+                                    "blackman-harris or kaiser. Also the window of the Welch segments.",
+                                    "window");
+    QCommandLineOption welchOption("welch", "Write the Welch PSD with segments of this many samples.", "samples");
+    QCommandLineOption jobsOption({"j", "jobs"}, "Threads to use (default: all cores).", "count");
+    QCommandLineOption noSamplesOption("no-samples", "Do not write the samples.");
+    parser.addOptions({outputOption, formatOption, windowOption, welchOption, jobsOption, noSamplesOption});
+    parser.process(app);
+
+    if (parser.positionalArguments().size() != 1)
+        parser.showHelp(1);
+
+    Options options;
+    options.output = QDir(parser.value(outputOption));
+    options.binary = parser.value(formatOption) == "binary";
+    options.samples = !parser.isSet(noSamplesOption);
+    if (!options.binary && parser.value(formatOption) != "csv")
+    {
+        std::fprintf(stderr, "Unknown format %s\n", qPrintable(parser.value(formatOption)));
+        return 1;
+    }
+    if (parser.isSet(windowOption))
+    {
+        options.windowName = parser.value(windowOption).toLower();
+        if (!parseWindow(options.windowName, options.window))
+        {
+            std::fprintf(stderr, "Unknown window %s\n", qPrintable(options.windowName));
+            return 1;
+        }
+        options.windowed = true;
+    }
+    if (parser.isSet(welchOption))
+    {
+        bool ok = false;
+        options.welchSegment = parser.value(welchOption).toULong(&ok);
+        if (!ok || options.welchSegment == 0)
+        {
+            std::fprintf(stderr, "Invalid Welch segment length %s\n", qPrintable(parser.value(welchOption)));
+            return 1;
+        }
+    }
+    // Read by the pool when it starts, before anything uses it
+    if (parser.isSet(jobsOption))
+        qputenv("ELKAVOLK_THREADS", parser.value(jobsOption).toLatin1());
+
+    if (!options.output.exists() && !QDir().mkpath(options.output.path()))
+    {
+        std::fprintf(stderr, "Cannot create %s\n", qPrintable(options.output.path()));
+        return 1;
+    }
+
+    QVariant input = readJsonProperty(parser.positionalArguments().first(), "signals");
+    if (!input.canConvert<QVariantList>())
+    {
+        std::fprintf(stderr, "No \"signals\" array in %s\n", qPrintable(parser.positionalArguments().first()));
+        return 1;
+    }
+
+    std::vector<Job> jobs;
+    for (const QVariant &value : input.toList())
+    {
+        Job job{Signal(value)};
+        job.base = fileName(static_cast<int>(jobs.size()), job.signal.name);
+        jobs.push_back(std::move(job));
+    }
+
+    // One signal per task; the FFTs inside share the same pool. The nesting is safe: waiting
+    // callers run queued chunks themselves, and every transform borrows its own scratch (scratch.h)
+    Clock::time_point start = Clock::now();
+    ThreadPool::shared().parallelFor(jobs.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+            run(jobs[i], options);
+    }, 1);
+    double wallMs = millisecondsSince(start);
+
+    std::printf("%-24s %12s %10s %10s %10s %10s %14s\n", "signal", "samples", "synth ms", "dft ms", "welch ms",
+                "write ms", "samples/s");
+    size_t totalSamples = 0;
+    double peak = 0.0;
+    int failures = 0;
+    for (const Job &job : jobs)
+    {
+        double computeMs = job.synthesisMs + job.spectrumMs + job.welchMs;
+        double throughput = computeMs > 0 ? job.sampleCount / (computeMs / 1000.0) : 0.0;
+        peak = std::max(peak, throughput);
+        totalSamples += job.sampleCount;
+        std::printf("%-24s %12zu %10.2f %10.2f %10.2f %10.2f %14.4g\n", qPrintable(job.base), job.sampleCount,
+                    job.synthesisMs, job.spectrumMs, job.welchMs, job.writeMs, throughput);
+        if (!job.error.isEmpty())
+        {
+            std::fprintf(stderr, "%s: %s\n", qPrintable(job.base), qPrintable(job.error));
+            failures++;
+        }
+    }
+    std::printf("%zu signals, %zu samples in %.2f ms on %zu threads: %.4g samples/s overall, peak %.4g samples/s\n",
+                jobs.size(), totalSamples, wallMs, ThreadPool::shared().size() + 1,
+                wallMs > 0 ? totalSamples / (wallMs / 1000.0) : 0.0, peak);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,202 @@
+// Benchmarks of the DSP core (Google Benchmark), for tracking regressions.
+//
+//   elkavolk_bench [--benchmark_filter=...]
+//
+// Results go to the console and, unless --benchmark_out is given, as JSON to elkavolk_bench.json.
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "decimate.h"
+#include "pyramid.h"
+#include "samplesource.h"
+#include "spectrum.h"
+#include "synth.h"
+
+namespace
+{
+
+constexpr double SAMPLE_RATE = 44100.0;
+
+// Harmonic series on 220 Hz with falling amplitudes, like a typical signal of data.json
+OvertoneBank makeBank(size_t tones)
+{
+    OvertoneBank bank;
+    for (size_t k = 1; k <= tones; k++)
+        bank.add(1.0 / static_cast<double>(k * tones), 220.0 * static_cast<double>(k), 0.1 * static_cast<double>(k));
+    return bank;
+}
+
+std::vector<double> makeSamples(size_t count, size_t tones = 8)
+{
+    std::vector<double> samples(count);
+    synthesize(makeBank(tones), SAMPLE_RATE, 0, count, samples.data());
+    return samples;
+}
+
+// Signal::getSamples: one second at 44.1 kHz, by number of overtones
+void BM_GetSamples(benchmark::State &state)
+{
+    const OvertoneBank bank = makeBank(static_cast<size_t>(state.range(0)));
+    std::vector<double> samples(static_cast<size_t>(SAMPLE_RATE));
+    for (auto _ : state)
+    {
+        synthesize(bank, SAMPLE_RATE, 0, samples.size(), samples.data());
+        benchmark::DoNotOptimize(samples.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(samples.size()));
+}
+BENCHMARK(BM_GetSamples)->Arg(1)->Arg(4)->Arg(16)->Arg(64)->Arg(256);
+
+// Signal::getRealDFT: the DFT is as long as the sample rate, so sizes include
+// 44100 and other lengths that are not powers of two. The copy of the samples is part of
+// the call, as getRealDFT takes them by value
+void BM_GetRealDFT(benchmark::State &state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    const std::vector<double> samples = makeSamples(n);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(realDFT(samples, n));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GetRealDFT)->Arg(1000)->Arg(1024)->Arg(8000)->Arg(22050)->Arg(44100)->Arg(48000)->Arg(65536);
+
+// The same under a Hann window, applied inside the FFT input pass
+void BM_GetRealDFTWindowed(benchmark::State &state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    const std::vector<double> samples = makeSamples(n);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(realDFT(samples, n, WindowType::Hann));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GetRealDFTWindowed)->Arg(1024)->Arg(44100)->Arg(65536);
+
+// Signal::getDFT: the real DFT completed with the conjugate upper half
+void BM_GetDFT(benchmark::State &state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    const std::vector<double> samples = makeSamples(n);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(mirrorSpectrum(realDFT(samples, n), n));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GetDFT)->Arg(1024)->Arg(44100)->Arg(65536);
+
+// Generator: streaming synthesis of one audio block and its conversion to 16-bit PCM
+void BM_GeneratorBlock(benchmark::State &state)
+{
+    const OvertoneBank bank = makeBank(static_cast<size_t>(state.range(0)));
+    StreamingSynth synth;
+    synth.reset(bank, SAMPLE_RATE);
+    std::vector<double> block(SYNTH_BLOCK);
+    std::vector<unsigned char> pcm(2 * SYNTH_BLOCK);
+    for (auto _ : state)
+    {
+        synth.render(block.data(), block.size());
+        encodePcm16(block.data(), block.size(), pcm.data());
+        benchmark::DoNotOptimize(pcm.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(block.size()));
+}
+BENCHMARK(BM_GeneratorBlock)->Arg(4)->Arg(64);
+
+// Generator::writeSamples alone
+void BM_EncodePcm16(benchmark::State &state)
+{
+    const std::vector<double> samples = makeSamples(static_cast<size_t>(state.range(0)));
+    std::vector<unsigned char> pcm(2 * samples.size());
+    for (auto _ : state)
+    {
+        encodePcm16(samples.data(), samples.size(), pcm.data());
+        benchmark::DoNotOptimize(pcm.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(pcm.size()));
+}
+BENCHMARK(BM_EncodePcm16)->Arg(1024)->Arg(44100);
+
+// Chart preparation: a whole signal reduced for a 1000 pixel wide chart
+constexpr size_t CHART_PIXELS = 1000;
+
+void BM_ChartMinMax(benchmark::State &state)
+{
+    const std::vector<double> samples = makeSamples(static_cast<size_t>(state.range(0)));
+    std::vector<PlotPoint> points;
+    for (auto _ : state)
+    {
+        decimate(Decimation::MinMax, samples.data(), 0, samples.size(), CHART_PIXELS, points);
+        benchmark::DoNotOptimize(points.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ChartMinMax)->Arg(44100)->Arg(441000)->Arg(4410000);
+
+void BM_ChartLTTB(benchmark::State &state)
+{
+    const std::vector<double> samples = makeSamples(static_cast<size_t>(state.range(0)));
+    std::vector<PlotPoint> points;
+    for (auto _ : state)
+    {
+        decimate(Decimation::LTTB, samples.data(), 0, samples.size(), CHART_PIXELS, points);
+        benchmark::DoNotOptimize(points.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ChartLTTB)->Arg(44100)->Arg(441000)->Arg(4410000);
+
+// Building the pyramid once per analysis, then every pan and zoom served from it
+void BM_ChartPyramidBuild(benchmark::State &state)
+{
+    const std::vector<double> samples = makeSamples(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        MinMaxPyramid pyramid;
+        pyramid.build(samples.data(), samples.size());
+        benchmark::DoNotOptimize(pyramid);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ChartPyramidBuild)->Arg(441000)->Arg(4410000);
+
+void BM_ChartPyramidEnvelope(benchmark::State &state)
+{
+    const std::vector<double> samples = makeSamples(static_cast<size_t>(state.range(0)));
+    MinMaxPyramid pyramid;
+    pyramid.build(samples.data(), samples.size());
+    std::vector<PlotPoint> points;
+    for (auto _ : state)
+    {
+        pyramid.envelope(samples.data(), 0, samples.size(), CHART_PIXELS, points);
+        benchmark::DoNotOptimize(points.data());
+    }
+}
+BENCHMARK(BM_ChartPyramidEnvelope)->Arg(441000)->Arg(4410000);
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    // Keep a JSON copy of the results unless told where to put them
+    std::vector<char *> args(argv, argv + argc);
+    bool hasOutput = std::any_of(args.begin(), args.end(),
+                                 [](const char *arg) { return std::string(arg).rfind("--benchmark_out=", 0) == 0; });
+    std::string output = "--benchmark_out=elkavolk_bench.json";
+    std::string format = "--benchmark_out_format=json";
+    if (!hasOutput)
+    {
+        args.push_back(&output[0]);
+        args.push_back(&format[0]);
+    }
+    int count = static_cast<int>(args.size());
+
+    benchmark::Initialize(&count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(count, args.data()))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
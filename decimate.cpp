@@ -0,0 +1,122 @@
+#include "decimate.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+void copyRange(const double *y, size_t begin, size_t end, std::vector<PlotPoint> &out)
+{
+    for (size_t i = begin; i < end; i++)
+        out.push_back({static_cast<double>(i), y[i]});
+}
+
+} // namespace
+
+void minMaxDecimate(const double *y, size_t begin, size_t end, size_t buckets, std::vector<PlotPoint> &out)
+{
+    out.clear();
+    if (end <= begin)
+        return;
+
+    const size_t length = end - begin;
+    if (buckets == 0 || length <= 2 * buckets)
+    {
+        copyRange(y, begin, end, out);
+        return;
+    }
+
+    out.reserve(2 * buckets);
+    for (size_t b = 0; b < buckets; b++)
+    {
+        size_t from = begin + b * length / buckets;
+        size_t to = begin + (b + 1) * length / buckets;
+
+        size_t lo = from, hi = from;
+        for (size_t i = from + 1; i < to; i++)
+        {
+            if (y[i] < y[lo])
+                lo = i;
+            if (y[i] > y[hi])
+                hi = i;
+        }
+
+        // In order of occurrence, so the line goes through them as the samples do
+        size_t first = std::min(lo, hi), second = std::max(lo, hi);
+        out.push_back({static_cast<double>(first), y[first]});
+        if (second != first)
+            out.push_back({static_cast<double>(second), y[second]});
+    }
+}
+
+void lttbDecimate(const double *y, size_t begin, size_t end, size_t threshold, std::vector<PlotPoint> &out)
+{
+    out.clear();
+    if (end <= begin)
+        return;
+
+    const size_t length = end - begin;
+    threshold = std::max<size_t>(threshold, 3);
+    if (length <= threshold)
+    {
+        copyRange(y, begin, end, out);
+        return;
+    }
+
+    out.reserve(threshold);
+    out.push_back({static_cast<double>(begin), y[begin]});
+
+    // Buckets share the points between the first and the last one
+    const double every = static_cast<double>(length - 2) / (threshold - 2);
+    size_t picked = begin;
+    for (size_t b = 0; b < threshold - 2; b++)
+    {
+        size_t from = begin + 1 + static_cast<size_t>(std::floor(b * every));
+        size_t to = begin + 1 + static_cast<size_t>(std::floor((b + 1) * every));
+
+        // Mean of the next bucket, the last point for the last bucket
+        size_t nextFrom = to;
+        size_t nextTo = std::min(end, begin + 1 + static_cast<size_t>(std::floor((b + 2) * every)));
+        if (nextFrom >= nextTo)
+        {
+            nextFrom = end - 1;
+            nextTo = end;
+        }
+        double meanX = 0.0, meanY = 0.0;
+        for (size_t i = nextFrom; i < nextTo; i++)
+        {
+            meanX += static_cast<double>(i);
+            meanY += y[i];
+        }
+        meanX /= static_cast<double>(nextTo - nextFrom);
+        meanY /= static_cast<double>(nextTo - nextFrom);
+
+        const double ax = static_cast<double>(picked), ay = y[picked];
+        double largest = -1.0;
+        size_t best = from;
+        for (size_t i = from; i < to; i++)
+        {
+            // Twice the triangle area, the factor does not change the pick
+            double area = std::abs((ax - meanX) * (y[i] - ay) - (ax - static_cast<double>(i)) * (meanY - ay));
+            if (area > largest)
+            {
+                largest = area;
+                best = i;
+            }
+        }
+
+        out.push_back({static_cast<double>(best), y[best]});
+        picked = best;
+    }
+
+    out.push_back({static_cast<double>(end - 1), y[end - 1]});
+}
+
+void decimate(Decimation mode, const double *y, size_t begin, size_t end, size_t pixels,
+              std::vector<PlotPoint> &out)
+{
+    if (mode == Decimation::LTTB)
+        lttbDecimate(y, begin, end, 2 * pixels, out);
+    else
+        minMaxDecimate(y, begin, end, pixels, out);
+}
@@ -0,0 +1,34 @@
+#ifndef DECIMATE_H
+#define DECIMATE_H
+#include <cstddef>
+#include <vector>
+
+// Reduction of long series y[i], plotted at x = i, to a few points per horizontal pixel.
+// A chart cannot show more than that anyway, and QtCharts slows down with every point it gets.
+
+struct PlotPoint
+{
+    double x, y;
+};
+
+enum class Decimation
+{
+    MinMax, // Envelope, never loses a peak (default for waveforms)
+    LTTB    // Largest-Triangle-Three-Buckets, keeps the visual shape with fewer points
+};
+
+// Min/max envelope of y[begin, end): the range is cut into `buckets` equal buckets and each one
+// contributes its minimum and its maximum in the order they occur, so the drawn line touches
+// exactly the values a full plot would. Short ranges are copied as they are.
+void minMaxDecimate(const double *y, size_t begin, size_t end, size_t buckets, std::vector<PlotPoint> &out);
+
+// Largest-Triangle-Three-Buckets (Steinarsson, 2013): keeps the first and the last point and,
+// from every bucket in between, the point forming the largest triangle with the previous pick
+// and the mean of the next bucket. `threshold` points in total.
+void lttbDecimate(const double *y, size_t begin, size_t end, size_t threshold, std::vector<PlotPoint> &out);
+
+// Decimate y[begin, end) for a plot `pixels` wide, about two points per pixel
+void decimate(Decimation mode, const double *y, size_t begin, size_t end, size_t pixels,
+              std::vector<PlotPoint> &out);
+
+#endif // DECIMATE_H
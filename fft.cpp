@@ -0,0 +1,434 @@
+#include "fft.h"
+#include "scratch.h"
+#include "sharedcache.h"
+#include "simd.h"
+#include "threadpool.h"
+#include <atomic>
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+using cpx = std::complex<double>;
+
+namespace
+{
+
+// Largest prime factor handled by mixed-radix stages,
+// lengths with a bigger prime factor are computed with Bluestein's algorithm
+constexpr size_t MAX_RADIX = 13;
+
+// Split n into the radices of the stages (4s first, then 2, 3, 5, 7, ...)
+// Return false if n has a prime factor greater than MAX_RADIX
+bool factorize(size_t n, std::vector<size_t> &radices)
+{
+    radices.clear();
+    while (n % 4 == 0)
+    {
+        radices.push_back(4);
+        n /= 4;
+    }
+    if (n % 2 == 0)
+    {
+        radices.push_back(2);
+        n /= 2;
+    }
+    for (size_t p = 3; p <= MAX_RADIX && n > 1; p += 2)
+    {
+        while (n % p == 0)
+        {
+            radices.push_back(p);
+            n /= p;
+        }
+    }
+    return n == 1;
+}
+
+// Mixed-radix digit reversal: position p of the permuted array holds x[rev[p]]
+// so that decimation-in-time stages can work in place
+std::vector<size_t> digitReversal(const std::vector<size_t> &radices)
+{
+    std::vector<size_t> rev{0};
+    for (size_t radix : radices)
+    {
+        size_t prev = rev.size();
+        std::vector<size_t> next(prev * radix);
+        for (size_t q = 0; q < radix; q++)
+            for (size_t p = 0; p < prev; p++)
+                next[q * prev + p] = q + radix * rev[p];
+        rev.swap(next);
+    }
+    return rev;
+}
+
+// exp(sign * 2*pi*i * k / n) with k reduced to keep the argument small
+cpx root(size_t k, size_t n, double sign)
+{
+    k %= n;
+    double angle = sign * 2.0 * M_PI * static_cast<double>(k) / static_cast<double>(n);
+    return {std::cos(angle), std::sin(angle)};
+}
+
+// 2^18 points: below that the transform takes about a millisecond and threads do not pay off
+std::atomic<size_t> parallelMinimum{size_t(1) << 18};
+
+// Lengths in use at once: the signal, the STFT frame, Welch segments and their sub-plans
+SharedCache<std::pair<size_t, bool>, FFTPlan> cache(64);
+SharedCache<size_t, RealFFTPlan> realCache(32);
+
+} // namespace
+
+std::shared_ptr<const FFTPlan> FFTPlan::get(size_t n, bool inverse)
+{
+    // Bluestein plans fetch their padded sub-plans from the cache while being built
+    return cache.get({n, inverse}, [=] { return std::make_shared<const FFTPlan>(n, inverse); });
+}
+
+void FFTPlan::clearCache()
+{
+    cache.clear();
+}
+
+std::shared_ptr<const RealFFTPlan> RealFFTPlan::get(size_t n)
+{
+    return realCache.get(n, [=] { return std::make_shared<const RealFFTPlan>(n); });
+}
+
+void RealFFTPlan::clearCache()
+{
+    realCache.clear();
+}
+
+FFTPlan::FFTPlan(size_t n, bool inverse)
+    : n(n), inverse(inverse)
+{
+    if (n <= 1)
+        return;
+
+    const double sign = inverse ? 1.0 : -1.0;
+    std::vector<size_t> radices;
+    if (factorize(n, radices))
+    {
+        permutation = digitReversal(radices);
+
+        size_t prev = 1;
+        for (size_t radix : radices)
+        {
+            size_t len = prev * radix;
+            Stage stage{radix, prev, twiddlesRe.size(), roots.size()};
+            for (size_t q = 1; q < radix; q++)
+            {
+                for (size_t j = 0; j < prev; j++)
+                {
+                    cpx w = root(j * q, len, sign);
+                    twiddlesRe.push_back(w.real());
+                    twiddlesIm.push_back(w.imag());
+                }
+            }
+            for (size_t q = 0; q < radix; q++)
+                roots.push_back(root(q, radix, sign));
+            stages.push_back(stage);
+            prev = len;
+        }
+        return;
+    }
+
+    // Bluestein's algorithm: express the DFT of any length as a convolution
+    // with a chirp and compute it with power-of-two FFTs
+    // https://en.wikipedia.org/wiki/Chirp_Z-transform#Bluestein.27s_algorithm
+    size_t m = 1;
+    while (m < 2 * n - 1)
+        m <<= 1;
+
+    // k^2 is reduced mod 2n to keep precision
+    chirp.resize(n);
+    for (size_t k = 0; k < n; k++)
+        chirp[k] = root((k * k) % (2 * n), 2 * n, sign);
+
+    forwardPadded = get(m, false);
+    inversePadded = get(m, true);
+
+    const double scale = 1.0 / static_cast<double>(m);
+    kernel.assign(m, 0.0);
+    kernel[0] = std::conj(chirp[0]) * scale;
+    for (size_t k = 1; k < n; k++)
+        kernel[k] = kernel[m - k] = std::conj(chirp[k]) * scale;
+    forwardPadded->execute(kernel.data());
+}
+
+size_t FFTPlan::parallelThreshold()
+{
+    return parallelMinimum;
+}
+
+void FFTPlan::setParallelThreshold(size_t n)
+{
+    parallelMinimum = n;
+}
+
+void FFTPlan::execute(cpx *data) const
+{
+    run(data, true);
+}
+
+void FFTPlan::run(cpx *data, bool parallel) const
+{
+    if (n <= 1)
+        return;
+    if (stages.empty())
+    {
+        bluestein(data, parallel);
+        return;
+    }
+    if (parallel && stages.size() > 1 && n >= parallelMinimum && ThreadPool::shared().size() > 0)
+        fourStep(data);
+    else
+        mixedRadix(data);
+}
+
+// Four-step FFT: view x as a rows x cols matrix x[j1*cols + j2], then
+//   1. transform every column over j1 and multiply by w_n^(j2*k1)
+//   2. transform every row over j2
+//   3. read the result transposed: X[k1 + rows*k2] = Z[k1][k2]
+// Each step is split across the shared thread pool.
+// https://en.wikipedia.org/wiki/Cooley%E2%80%93Tukey_FFT_algorithm#Variations
+void FFTPlan::fourStep(cpx *data) const
+{
+    std::call_once(fourStepOnce, [this] {
+        auto split = std::make_unique<FourStep>();
+
+        // Group the stage radices into two factors close to sqrt(n)
+        split->rows = 1;
+        for (const Stage &st : stages)
+        {
+            if (split->rows * split->rows >= n)
+                break;
+            split->rows *= st.radix;
+        }
+        split->cols = n / split->rows;
+
+        const double sign = inverse ? 1.0 : -1.0;
+        split->columnPlan = get(split->rows, inverse);
+        split->rowPlan = get(split->cols, inverse);
+        split->block = split->cols;
+        for (size_t r = 0; r < split->block; r++)
+            split->low.push_back(root(r, n, sign));
+        for (size_t q = 0; q * split->block < n; q++)
+            split->high.push_back(root(q * split->block, n, sign));
+        fourStepData = std::move(split);
+    });
+
+    const FourStep &fs = *fourStepData;
+    const size_t rows = fs.rows, cols = fs.cols;
+    ScratchBuffer<cpx> matrixBuffer(n); // Held across the waits of parallelFor, see scratch.h
+    cpx *matrix = matrixBuffer.data();
+    ThreadPool &pool = ThreadPool::shared();
+
+    // Columns: gather, transform, twiddle, store as rows of the matrix
+    pool.parallelFor(cols, [&](size_t begin, size_t end) {
+        ScratchBuffer<cpx> columnBuffer(rows);
+        cpx *column = columnBuffer.data();
+        for (size_t j2 = begin; j2 < end; j2++)
+        {
+            for (size_t j1 = 0; j1 < rows; j1++)
+                column[j1] = data[j1 * cols + j2];
+            fs.columnPlan->run(column, false);
+            for (size_t k1 = 0; k1 < rows; k1++)
+            {
+                size_t m = (j2 * k1) % n;
+                matrix[k1 * cols + j2] = column[k1] * fs.high[m / fs.block] * fs.low[m % fs.block];
+            }
+        }
+    }, 16);
+
+    // Rows: transform in place, then write transposed into the output
+    pool.parallelFor(rows, [&](size_t begin, size_t end) {
+        for (size_t k1 = begin; k1 < end; k1++)
+        {
+            cpx *row = matrix + k1 * cols;
+            fs.rowPlan->run(row, false);
+            for (size_t k2 = 0; k2 < cols; k2++)
+                data[k1 + rows * k2] = row[k2];
+        }
+    }, 16);
+}
+
+void FFTPlan::mixedRadix(cpx *a) const
+{
+    // Reorder the input by digit reversal while splitting it into real and imaginary arrays
+    ScratchBuffer<double> reBuffer(n), imBuffer(n);
+    double *re = reBuffer.data();
+    double *im = imBuffer.data();
+    for (size_t p = 0; p < n; p++)
+    {
+        re[p] = a[permutation[p]].real();
+        im[p] = a[permutation[p]].imag();
+    }
+
+    const SimdKernels &kernels = simdKernels();
+    const double sign = inverse ? 1.0 : -1.0;
+    const double s3 = sign * std::sqrt(3.0) / 2.0;
+    double xr[MAX_RADIX], xi[MAX_RADIX];
+
+    for (const Stage &st : stages)
+    {
+        const size_t radix = st.radix, prev = st.prev, len = prev * radix;
+        const double *twRe = &twiddlesRe[st.twiddles];
+        const double *twIm = &twiddlesIm[st.twiddles];
+
+        if (radix == 2)
+        {
+            kernels.radix2Stage(re, im, n, prev, twRe, twIm);
+            continue;
+        }
+        if (radix == 4)
+        {
+            kernels.radix4Stage(re, im, n, prev, twRe, twIm, sign);
+            continue;
+        }
+
+        const cpx *w = &roots[st.roots];
+        for (size_t b = 0; b < n; b += len)
+        {
+            for (size_t j = 0; j < prev; j++)
+            {
+                double *pr = re + b + j, *pi = im + b + j;
+                xr[0] = pr[0];
+                xi[0] = pi[0];
+                for (size_t q = 1; q < radix; q++)
+                {
+                    double tr = twRe[(q - 1) * prev + j], ti = twIm[(q - 1) * prev + j];
+                    xr[q] = pr[q * prev] * tr - pi[q * prev] * ti;
+                    xi[q] = pr[q * prev] * ti + pi[q * prev] * tr;
+                }
+
+                if (radix == 3)
+                {
+                    double sumr = xr[1] + xr[2], sumi = xi[1] + xi[2];
+                    double midr = xr[0] - 0.5 * sumr, midi = xi[0] - 0.5 * sumi;
+                    double rotr = -s3 * (xi[1] - xi[2]), roti = s3 * (xr[1] - xr[2]); // (x1 - x2) * i*s3
+                    pr[0] = xr[0] + sumr;
+                    pi[0] = xi[0] + sumi;
+                    pr[prev] = midr + rotr;
+                    pi[prev] = midi + roti;
+                    pr[2 * prev] = midr - rotr;
+                    pi[2 * prev] = midi - roti;
+                    continue;
+                }
+
+                // Generic radix-point DFT for the remaining small primes
+                for (size_t s = 0; s < radix; s++)
+                {
+                    double sumr = xr[0], sumi = xi[0];
+                    for (size_t q = 1; q < radix; q++)
+                    {
+                        const cpx &r = w[(q * s) % radix];
+                        sumr += xr[q] * r.real() - xi[q] * r.imag();
+                        sumi += xr[q] * r.imag() + xi[q] * r.real();
+                    }
+                    pr[s * prev] = sumr;
+                    pi[s * prev] = sumi;
+                }
+            }
+        }
+    }
+
+    for (size_t p = 0; p < n; p++)
+        a[p] = cpx(re[p], im[p]);
+}
+
+void FFTPlan::bluestein(cpx *a, bool parallel) const
+{
+    const size_t m = kernel.size();
+    ScratchBuffer<cpx> buffer(m);
+    cpx *u = buffer.data();
+
+    for (size_t k = 0; k < n; k++)
+        u[k] = a[k] * chirp[k];
+    std::fill(u + n, u + m, cpx(0.0));
+
+    // Circular convolution with the chirp kernel (already transformed and scaled)
+    forwardPadded->run(u, parallel);
+    simdKernels().complexMultiplyInterleaved(u, kernel.data(), m);
+    inversePadded->run(u, parallel);
+
+    for (size_t k = 0; k < n; k++)
+        a[k] = u[k] * chirp[k];
+}
+
+RealFFTPlan::RealFFTPlan(size_t n)
+    : n(n)
+{
+    if (n % 2 != 0)
+    {
+        complexPlan = FFTPlan::get(n, false);
+        return;
+    }
+
+    complexPlan = FFTPlan::get(n / 2, false);
+    twiddles.resize(n / 2 + 1);
+    for (size_t k = 0; k <= n / 2; k++)
+        twiddles[k] = root(k, n, -1.0);
+}
+
+void RealFFTPlan::execute(const double *in, cpx *out, const double *window) const
+{
+    if (n == 0)
+        return;
+
+    if (n % 2 != 0)
+    {
+        // Odd length: plain complex transform, keep the first half
+        ScratchBuffer<cpx> buffer(n);
+        cpx *tmp = buffer.data();
+        for (size_t k = 0; k < n; k++)
+            tmp[k] = window ? in[k] * window[k] : in[k];
+        complexPlan->execute(tmp);
+        std::copy(tmp, tmp + bins(), out);
+        return;
+    }
+
+    // z[k] = x[2k] + i*x[2k+1]
+    const size_t m = n / 2;
+    ScratchBuffer<cpx> buffer(m);
+    cpx *z = buffer.data();
+    if (window)
+    {
+        for (size_t k = 0; k < m; k++)
+            z[k] = cpx(in[2 * k] * window[2 * k], in[2 * k + 1] * window[2 * k + 1]);
+    }
+    else
+    {
+        for (size_t k = 0; k < m; k++)
+            z[k] = cpx(in[2 * k], in[2 * k + 1]);
+    }
+    complexPlan->execute(z);
+
+    // Split Z into the spectra of the even (E) and odd (O) samples:
+    // E[k] = (Z[k] + conj(Z[m-k])) / 2, O[k] = (Z[k] - conj(Z[m-k])) / 2i
+    // then X[k] = E[k] + exp(-2*pi*i * k / n) * O[k]
+    for (size_t k = 0; k <= m; k++)
+    {
+        cpx a = z[k % m];
+        cpx b = std::conj(z[(m - k) % m]);
+        cpx even = 0.5 * (a + b);
+        cpx diff = 0.5 * (a - b);
+        cpx odd(diff.imag(), -diff.real()); // diff / i
+        out[k] = even + twiddles[k] * odd;
+    }
+}
+
+std::vector<cpx> rfft(const double *data, size_t n, const double *window)
+{
+    if (n == 0)
+        return {};
+    std::vector<cpx> out(n / 2 + 1);
+    RealFFTPlan::get(n)->execute(data, out.data(), window);
+    return out;
+}
+
+void fft(cpx *data, size_t n, bool inverse)
+{
+    if (n <= 1)
+        return;
+    FFTPlan::get(n, inverse)->execute(data);
+}
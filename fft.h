@@ -0,0 +1,148 @@
+#ifndef FFT_H
+#define FFT_H
+#include <vector>
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+// Fast Fourier Transform of any length
+//  - power-of-two lengths run radix-4 stages (plus one radix-2 stage when log2(N) is odd)
+//  - lengths whose prime factors are all <= 13 run mixed-radix stages (2, 3, 4, 5, 7, 11, 13)
+//  - every other length goes through Bluestein's chirp-z algorithm on a power-of-two FFT
+// so the cost stays O(N log N) whatever the length is.
+//
+// The forward transform is X[k] = sum x[n] * exp(-2*pi*i*k*n/N), i.e. the same definition
+// as the direct DFT. The inverse uses exp(+2*pi*i*k*n/N) and is NOT scaled by 1/N.
+//
+// Accuracy: every bin matches the direct O(N^2) summation to within 1e-14 * sum(|x[n]|)
+// for every kind of length (the observed error stays below 5e-16 * sum(|x[n]|)),
+// checked by tests/fft_test.cpp.
+void fft(std::complex<double> *data, size_t n, bool inverse = false);
+
+inline void fft(std::vector<std::complex<double>> &data, bool inverse = false)
+{
+    fft(data.data(), data.size(), inverse);
+}
+
+// Precomputed transform of one length and direction.
+// A plan owns everything that does not depend on the data: the stage radices,
+// the digit-reversal permutation, the twiddle tables and, for Bluestein lengths,
+// the chirp and its transformed convolution kernel. Executing a plan makes no
+// trigonometric calls and, once the calling thread's scratch buffers have grown
+// to the plan length, no allocations. The stages run on split real/imaginary
+// arrays so radix-2 and radix-4 butterflies use the SIMD kernels of simd.h.
+class FFTPlan
+{
+public:
+    // Shared plan for the given length and direction.
+    // Plans are built on first use and kept in a process-wide cache of the 64 most recently used
+    // (see sharedcache.h), safe to call from any thread
+    static std::shared_ptr<const FFTPlan> get(size_t n, bool inverse = false);
+
+    // Drop every cached plan (plans still referenced elsewhere stay alive)
+    static void clearCache();
+
+    FFTPlan(size_t n, bool inverse);
+
+    size_t size() const { return n; }
+    bool isInverse() const { return inverse; }
+
+    // Transform n values in place.
+    // Mixed-radix lengths of at least parallelThreshold() run as a four-step FFT
+    // (parallel column transforms, twiddle, parallel row transforms, transpose)
+    // on the shared ThreadPool; Bluestein lengths parallelize their padded transforms.
+    void execute(std::complex<double> *data) const;
+
+    // Smallest length transformed on several threads, smaller ones stay single-threaded
+    static size_t parallelThreshold();
+    static void setParallelThreshold(size_t n);
+
+private:
+    // Four-step split n = rows * cols, built on the first parallel execution
+    struct FourStep
+    {
+        size_t rows; // Length of the column transforms
+        size_t cols; // Length of the row transforms
+        std::shared_ptr<const FFTPlan> columnPlan;
+        std::shared_ptr<const FFTPlan> rowPlan;
+        // Twiddles w_n^m = high[m / block] * low[m % block], about 2*sqrt(n) values instead of n
+        size_t block;
+        std::vector<std::complex<double>> low;
+        std::vector<std::complex<double>> high;
+    };
+
+    void run(std::complex<double> *data, bool parallel) const;
+    void fourStep(std::complex<double> *data) const;
+    // One decimation-in-time stage combining radix transforms of length prev
+    struct Stage
+    {
+        size_t radix;
+        size_t prev;
+        size_t twiddles; // Offset of w_(prev*radix)^(j*q) at (q-1)*prev + j in twiddlesRe/Im, j < prev, 1 <= q < radix
+        size_t roots;    // Offset of the radix-point roots of unity in roots
+    };
+
+    void mixedRadix(std::complex<double> *data) const;
+    void bluestein(std::complex<double> *data, bool parallel) const;
+
+    size_t n;
+    bool inverse;
+
+    // Mixed-radix lengths
+    std::vector<Stage> stages;
+    std::vector<size_t> permutation; // Position p of the reordered input holds x[permutation[p]]
+    std::vector<double> twiddlesRe;  // Split layout for the vectorized butterflies (see simd.h)
+    std::vector<double> twiddlesIm;
+    std::vector<std::complex<double>> roots;
+    mutable std::once_flag fourStepOnce;
+    mutable std::unique_ptr<const FourStep> fourStepData;
+
+    // Bluestein lengths
+    std::vector<std::complex<double>> chirp;  // exp(sign * pi*i * k^2 / n)
+    std::vector<std::complex<double>> kernel; // FFT of conj(chirp) wrapped to the padded length, scaled by 1/m
+    std::shared_ptr<const FFTPlan> forwardPadded;
+    std::shared_ptr<const FFTPlan> inversePadded;
+};
+
+// Forward transform of n real values: returns the n/2+1 non-redundant bins,
+// the remaining ones are X[n-k] = conj(X[k]).
+// With window (n coefficients, see window.h) the transform is of data[k] * window[k]
+std::vector<std::complex<double>> rfft(const double *data, size_t n, const double *window = nullptr);
+
+inline std::vector<std::complex<double>> rfft(const std::vector<double> &data)
+{
+    return rfft(data.data(), data.size());
+}
+
+// Precomputed forward transform of real input.
+// Even lengths pack the n reals as n/2 complex values (even samples in the real part,
+// odd samples in the imaginary part), run a half-length complex FFT and split the result
+// with one extra twiddle pass, which roughly halves the work and the memory of a complex FFT.
+// Odd lengths fall back to the complex plan of the full length.
+class RealFFTPlan
+{
+public:
+    // Shared plan for the given length, cached like FFTPlan::get
+    static std::shared_ptr<const RealFFTPlan> get(size_t n);
+
+    // Drop every cached plan
+    static void clearCache();
+
+    explicit RealFFTPlan(size_t n);
+
+    size_t size() const { return n; }
+    // Number of output bins, n/2+1
+    size_t bins() const { return n / 2 + 1; }
+
+    // Transform n reals from in into bins() values of out.
+    // A window of n coefficients is applied while the input is packed, at no extra pass
+    void execute(const double *in, std::complex<double> *out, const double *window = nullptr) const;
+
+private:
+    size_t n;
+    std::shared_ptr<const FFTPlan> complexPlan; // n/2 points for even n, n points otherwise
+    std::vector<std::complex<double>> twiddles; // exp(-2*pi*i * k / n), k <= n/2 (even n only)
+};
+
+#endif // FFT_H
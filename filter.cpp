@@ -0,0 +1,311 @@
+#include "filter.h"
+#include "fft.h"
+#include "window.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+// Largest overlap-save block, longer kernels are split into partitions of this length
+constexpr size_t MAX_PARTITION = 4096;
+
+// Samples filtered between two checks for cancellation
+constexpr size_t CANCEL_BLOCK = 65536;
+
+// Windowed-sinc low-pass with the given cutoff as a fraction of the sample rate, unity gain at DC.
+// Symmetric Hamming taper: the periodic table one shorter, closed with its first value
+std::vector<double> lowPassKernel(double cutoff, size_t taps)
+{
+    std::vector<double> kernel(taps);
+    std::shared_ptr<const Window> window = Window::get(WindowType::Hamming, taps - 1);
+    const double middle = 0.5 * static_cast<double>(taps - 1);
+    double sum = 0.0;
+    for (size_t n = 0; n < taps; n++)
+    {
+        double t = static_cast<double>(n) - middle;
+        double sinc = t == 0.0 ? 2.0 * cutoff : std::sin(2.0 * M_PI * cutoff * t) / (M_PI * t);
+        kernel[n] = sinc * (n < taps - 1 ? (*window)[n] : (*window)[0]);
+        sum += kernel[n];
+    }
+    for (double &tap : kernel)
+        tap /= sum;
+    return kernel;
+}
+
+// Butterworth sections of the given order, bilinear transform with prewarping
+// (the second-order ones are the Audio EQ Cookbook sections at the Butterworth pole Q's)
+void butterworth(bool highPass, double cutoff, size_t order, std::vector<Biquad> &sections)
+{
+    const double w0 = 2.0 * M_PI * cutoff;
+    const double cw = std::cos(w0);
+    const double sw = std::sin(w0);
+    for (size_t k = 0; k < order / 2; k++)
+    {
+        // Pole pairs at these angles from the negative real axis: (2k+1)*pi/(2N) for even orders,
+        // (k+1)*pi/N for odd ones, whose remaining real pole is the first-order section below
+        double angle = order % 2 ? M_PI * (k + 1.0) / order : M_PI * (2.0 * k + 1.0) / (2.0 * order);
+        double q = 1.0 / (2.0 * std::cos(angle));
+        double alpha = sw / (2.0 * q);
+        double a0 = 1.0 + alpha;
+        double b1 = highPass ? -(1.0 + cw) : 1.0 - cw;
+        sections.push_back({0.5 * std::abs(b1) / a0, b1 / a0, 0.5 * std::abs(b1) / a0, -2.0 * cw / a0,
+                            (1.0 - alpha) / a0});
+    }
+
+    // Odd orders end with a first-order section
+    if (order % 2)
+    {
+        double k = std::tan(0.5 * w0);
+        double b0 = (highPass ? 1.0 : k) / (1.0 + k);
+        sections.push_back({b0, highPass ? -b0 : b0, 0.0, (k - 1.0) / (k + 1.0), 0.0});
+    }
+}
+
+// State of a section between blocks
+struct SectionState
+{
+    double z1 = 0.0, z2 = 0.0;
+};
+
+// Direct form II transposed, one section over a block at a time
+void applySection(const Biquad &s, SectionState &state, double *data, size_t count)
+{
+    double z1 = state.z1, z2 = state.z2;
+    for (size_t n = 0; n < count; n++)
+    {
+        double x = data[n];
+        double y = s.b0 * x + z1;
+        z1 = s.b1 * x - s.a1 * y + z2;
+        z2 = s.b2 * x - s.a2 * y;
+        data[n] = y;
+    }
+    state.z1 = z1;
+    state.z2 = z2;
+}
+
+} // namespace
+
+Filter::Filter(const FilterSpec &spec, double sampleRate)
+    : filterSpec(spec), sampleRate(sampleRate)
+{
+    if (spec.design == FilterDesign::None || sampleRate <= 0)
+        return;
+
+    // Normalized cutoffs strictly between 0 and Nyquist
+    auto normalize = [sampleRate](double frequency) {
+        return std::clamp(frequency / sampleRate, 1e-6, 0.5 - 1e-6);
+    };
+    double low = normalize(spec.low);
+    double high = normalize(std::max(spec.low, spec.high));
+
+    if (spec.design == FilterDesign::FIR)
+    {
+        // Odd length: a whole-sample delay, and a high-pass needs a centre tap
+        size_t count = std::max<size_t>(spec.order, 3) | 1;
+        size_t middle = count / 2;
+        switch (spec.type)
+        {
+        case FilterType::LowPass:
+            taps = lowPassKernel(low, count);
+            break;
+        case FilterType::HighPass:
+            // Spectral inversion of the low-pass
+            taps = lowPassKernel(low, count);
+            for (double &tap : taps)
+                tap = -tap;
+            taps[middle] += 1.0;
+            break;
+        case FilterType::BandPass:
+        {
+            // Difference of two low-passes, scaled to unity gain at the band centre
+            taps = lowPassKernel(high, count);
+            std::vector<double> lower = lowPassKernel(low, count);
+            for (size_t n = 0; n < count; n++)
+                taps[n] -= lower[n];
+            double gain = std::abs(response(0.5 * (low + high) * sampleRate));
+            if (gain > 0)
+                for (double &tap : taps)
+                    tap /= gain;
+            break;
+        }
+        }
+        return;
+    }
+
+    size_t order = std::clamp<size_t>(spec.order, 1, MAX_IIR_ORDER);
+    switch (spec.type)
+    {
+    case FilterType::LowPass:
+        butterworth(false, low, order, biquads);
+        break;
+    case FilterType::HighPass:
+        butterworth(true, low, order, biquads);
+        break;
+    case FilterType::BandPass:
+        butterworth(true, low, order, biquads);
+        butterworth(false, high, order, biquads);
+        break;
+    }
+}
+
+void Filter::apply(const double *in, double *out, size_t count, const std::atomic<bool> *cancel) const
+{
+    if (!taps.empty())
+    {
+        convolve(in, count, taps.data(), taps.size(), out, cancel);
+        return;
+    }
+
+    // Every section over one block while it is in cache, then the next block
+    std::copy(in, in + count, out);
+    std::vector<SectionState> states(biquads.size());
+    for (size_t begin = 0; begin < count; begin += CANCEL_BLOCK)
+    {
+        if (cancel && *cancel)
+            return;
+        size_t length = std::min(CANCEL_BLOCK, count - begin);
+        for (size_t k = 0; k < biquads.size(); k++)
+            applySection(biquads[k], states[k], out + begin, length);
+    }
+}
+
+std::complex<double> Filter::response(double frequency) const
+{
+    if (taps.empty() && biquads.empty())
+        return 1.0;
+
+    const double w = 2.0 * M_PI * frequency / sampleRate;
+    const std::complex<double> z1 = std::polar(1.0, -w); // 1/z
+    const std::complex<double> z2 = z1 * z1;
+
+    if (!taps.empty())
+    {
+        // Horner's rule over 1/z
+        std::complex<double> sum = 0.0;
+        for (size_t n = taps.size(); n-- > 0;)
+            sum = sum * z1 + taps[n];
+        return sum;
+    }
+
+    std::complex<double> h = 1.0;
+    for (const Biquad &s : biquads)
+        h *= (s.b0 + s.b1 * z1 + s.b2 * z2) / (1.0 + s.a1 * z1 + s.a2 * z2);
+    return h;
+}
+
+std::vector<double> Filter::responseDb(size_t points) const
+{
+    std::vector<double> db(points);
+    if (points == 0)
+        return db;
+
+    // A FIR response on an even grid is the DFT of the kernel folded to the grid's length,
+    // one FFT instead of taps evaluations per point
+    std::vector<double> magnitude(points, 1.0);
+    if (!taps.empty() && points > 1)
+    {
+        std::vector<double> folded(2 * (points - 1), 0.0);
+        for (size_t n = 0; n < taps.size(); n++)
+            folded[n % folded.size()] += taps[n];
+        std::vector<std::complex<double>> bins = rfft(folded);
+        for (size_t k = 0; k < points; k++)
+            magnitude[k] = std::abs(bins[k]);
+    }
+    else if (!biquads.empty())
+    {
+        for (size_t k = 0; k < points; k++)
+            magnitude[k] = std::abs(response(points > 1 ? 0.5 * sampleRate * k / (points - 1) : 0.0));
+    }
+
+    for (size_t k = 0; k < points; k++)
+        db[k] = 20.0 * std::log10(std::max(magnitude[k], 1e-10)); // Floor at -200 dB
+    return db;
+}
+
+void convolve(const double *in, size_t count, const double *kernel, size_t taps, double *out,
+              const std::atomic<bool> *cancel)
+{
+    if (taps == 0)
+    {
+        std::fill(out, out + count, 0.0);
+        return;
+    }
+
+    if (taps <= DIRECT_CONVOLUTION_TAPS)
+    {
+        for (size_t n = 0; n < count; n++)
+        {
+            if (n % CANCEL_BLOCK == 0 && cancel && *cancel)
+                return;
+            size_t last = std::min(n + 1, taps);
+            double sum = 0.0;
+            for (size_t m = 0; m < last; m++)
+                sum += kernel[m] * in[n - m];
+            out[n] = sum;
+        }
+        return;
+    }
+
+    // Blocks of block samples, transformed over the previous and the current block
+    size_t block = 1;
+    while (block < taps && block < MAX_PARTITION)
+        block *= 2;
+    const size_t length = 2 * block;
+    const size_t bins = block + 1;
+    const size_t parts = (taps + block - 1) / block;
+    std::shared_ptr<const RealFFTPlan> forward = RealFFTPlan::get(length);
+    std::shared_ptr<const FFTPlan> inverse = FFTPlan::get(length, true);
+
+    // Spectra of the kernel partitions, zero-padded to the transform length
+    std::vector<std::complex<double>> partitions(parts * bins);
+    std::vector<double> frame(length, 0.0);
+    for (size_t p = 0; p < parts; p++)
+    {
+        size_t begin = p * block;
+        size_t end = std::min(taps, begin + block);
+        std::fill(frame.begin(), frame.end(), 0.0);
+        std::copy(kernel + begin, kernel + end, frame.begin());
+        forward->execute(frame.data(), partitions.data() + p * bins);
+    }
+
+    // Spectra of the last parts input frames, newest first from index newest
+    std::vector<std::complex<double>> delayLine(parts * bins, 0.0);
+    std::vector<std::complex<double>> spectrum(length);
+    size_t newest = 0;
+    std::fill(frame.begin(), frame.end(), 0.0);
+    for (size_t begin = 0; begin < count; begin += block)
+    {
+        if (cancel && *cancel)
+            return;
+        size_t n = std::min(block, count - begin);
+        std::copy(frame.begin() + block, frame.end(), frame.begin());
+        std::copy(in + begin, in + begin + n, frame.begin() + block);
+        std::fill(frame.begin() + block + n, frame.end(), 0.0);
+
+        newest = (newest + parts - 1) % parts;
+        forward->execute(frame.data(), delayLine.data() + newest * bins);
+
+        // Frame p blocks old meets the kernel partition p
+        std::fill(spectrum.begin(), spectrum.begin() + bins, 0.0);
+        for (size_t p = 0; p < parts; p++)
+        {
+            const std::complex<double> *x = delayLine.data() + ((newest + p) % parts) * bins;
+            const std::complex<double> *h = partitions.data() + p * bins;
+            for (size_t k = 0; k < bins; k++)
+            {
+                // Written out, std::complex multiplication checks for infinities
+                double re = x[k].real() * h[k].real() - x[k].imag() * h[k].imag();
+                double im = x[k].real() * h[k].imag() + x[k].imag() * h[k].real();
+                spectrum[k] += std::complex<double>(re, im);
+            }
+        }
+
+        // Hermitian completion for the complex inverse, the second half is free of wrap-around
+        for (size_t k = 1; k < block; k++)
+            spectrum[length - k] = std::conj(spectrum[k]);
+        inverse->execute(spectrum.data());
+        for (size_t i = 0; i < n; i++)
+            out[begin + i] = spectrum[block + i].real() / static_cast<double>(length);
+    }
+}
@@ -0,0 +1,94 @@
+#ifndef FILTER_H
+#define FILTER_H
+#include <atomic>
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+// Digital filters applied to the sampled signal
+// https://en.wikipedia.org/wiki/Digital_filter
+enum class FilterDesign
+{
+    None,
+    FIR, // Windowed sinc (Hamming), linear phase, delays by (taps - 1) / 2 samples
+    IIR  // Butterworth as a cascade of biquads, maximally flat pass band
+};
+
+enum class FilterType
+{
+    LowPass,  // Keeps frequencies below low
+    HighPass, // Keeps frequencies above low
+    BandPass  // Keeps frequencies between low and high
+};
+
+struct FilterSpec
+{
+    FilterDesign design = FilterDesign::None;
+    FilterType type = FilterType::LowPass;
+    double low = 1000.0;  // Cutoff in Hz (lower edge of a band-pass)
+    double high = 4000.0; // Upper edge of a band-pass in Hz
+    size_t order = 101;   // FIR taps (rounded up to odd) or IIR order (up to MAX_IIR_ORDER)
+
+    bool operator==(const FilterSpec &other) const
+    {
+        return design == other.design && type == other.type && low == other.low && high == other.high &&
+               order == other.order;
+    }
+    bool operator!=(const FilterSpec &other) const { return !(*this == other); }
+};
+
+// One second-order section: H(z) = (b0 + b1/z + b2/z^2) / (1 + a1/z + a2/z^2)
+struct Biquad
+{
+    double b0, b1, b2;
+    double a1, a2;
+};
+
+// Highest Butterworth order designed, higher orders are clamped to it. Beyond this the
+// sections' poles crowd the unit circle at low cutoffs and the cascade loses accuracy
+constexpr size_t MAX_IIR_ORDER = 20;
+
+// Coefficients of a FilterSpec at one sample rate.
+// Cutoffs are clamped inside (0, sampleRate / 2)
+class Filter
+{
+public:
+    Filter(const FilterSpec &spec, double sampleRate);
+
+    const FilterSpec &spec() const { return filterSpec; }
+    // FIR taps, empty for IIR filters
+    const std::vector<double> &kernel() const { return taps; }
+    // IIR sections, empty for FIR filters
+    const std::vector<Biquad> &sections() const { return biquads; }
+
+    // Filter count samples starting from silence, in and out must not overlap.
+    // FIR kernels longer than DIRECT_CONVOLUTION_TAPS go through convolve()'s FFT path.
+    // Stops between blocks once cancel becomes true, out is then only partly filtered
+    void apply(const double *in, double *out, size_t count, const std::atomic<bool> *cancel = nullptr) const;
+
+    // H(exp(2*pi*i * frequency / sampleRate))
+    std::complex<double> response(double frequency) const;
+
+    // |H| in dB at points frequencies evenly spaced from 0 to sampleRate / 2
+    std::vector<double> responseDb(size_t points) const;
+
+private:
+    FilterSpec filterSpec;
+    double sampleRate;
+    std::vector<double> taps;
+    std::vector<Biquad> biquads;
+};
+
+// Kernels up to this length are convolved directly, longer ones with FFTs
+constexpr size_t DIRECT_CONVOLUTION_TAPS = 64;
+
+// Causal convolution out[n] = sum over m of kernel[m] * in[n - m], for n < count, with silence before in.
+// Long kernels run uniformly partitioned overlap-save: the kernel is split into blocks of up to
+// 4096 taps, each transformed once, and every block of input costs one forward and one inverse
+// FFT of twice the block length plus a multiply-add per partition, O(count * log(taps)) for kernels
+// up to the block size instead of O(count * taps). in and out must not overlap.
+// Stops between blocks once cancel becomes true.
+void convolve(const double *in, size_t count, const double *kernel, size_t taps, double *out,
+              const std::atomic<bool> *cancel = nullptr);
+
+#endif // FILTER_H
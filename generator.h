@@ -5,29 +5,54 @@
 #include <QByteArray>
 #include <QtMath>
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+
 #include "signal.h"
+#include "triplebuffer.h"
+#include "ringbuffer.h"
+#include "resampler.h"
 
+// Streams a signal as 16-bit mono PCM.
+// Nothing is rendered up front: readData synthesizes exactly the requested bytes
+// from running oscillators, so memory stays constant, playback starts immediately
+// and looping playback can go on forever.
+// Edited parameters reach the playing sound through update(): the GUI thread publishes
+// them into a triple buffer and readData crossfades to them, without locks or allocations
+// on the audio side.
+// Recordings (Signal::source) are read from their source instead, chunk by chunk.
+// Signals whose rate the audio device does not take are played through a Resampler at the
+// device rate, converted block by block as they are synthesized.
+// Every rendered sample is also copied into monitor(), for a live display that reads
+// it on another thread; when the reader falls behind, samples are dropped, never waited for.
 class SineWaveGenerator : public QIODevice
 {
     Q_OBJECT
 public:
     SineWaveGenerator(QObject *parent = nullptr)
-        : QIODevice(parent), m_pos(0) {}
+        : QIODevice(parent), m_monitor(MONITOR_SAMPLES) {}
 
-    void start(Signal &signal)
+    // Play the signal over its duration, or endlessly from the start again when looping.
+    // outputRate is the device rate if it differs from the signal's, 0 otherwise
+    void start(Signal &signal, bool looping = false, int outputRate = 0)
     {
-        int sampleCount = signal.sampleRate * signal.duration;
-        m_data.resize(sampleCount * 2); // 16-bit mono = 2 bytes per sample
+        m_synth.reset(signal.getBank(), signal.sampleRate);
+        m_source = signal.source;
+        m_sourcePosition = 0;
+        m_sampleCount = signal.getSampleCount();
+        m_looping = looping;
 
-        for (int i = 0; i < sampleCount; ++i)
+        m_resampler.reset();
+        m_pendingBegin = m_pendingEnd = 0;
+        m_flushLeft = 0;
+        if (outputRate > 0 && outputRate != signal.sampleRate)
         {
-            qint16 sample = static_cast<qint16>(32767.0 *
-                signal.getValue(i / static_cast<double>(signal.sampleRate)));
-            m_data[2 * i] = static_cast<char>(sample & 0xFF);
-            m_data[2 * i + 1] = static_cast<char>((sample >> 8) & 0xFF);
+            m_resampler = std::make_unique<Resampler>(signal.sampleRate, outputRate);
+            m_resampled.resize(m_resampler->maxOutput(SYNTH_BLOCK));
+            m_flushLeft = m_resampler->latency();
         }
-
-        m_pos = 0;
         open(QIODevice::ReadOnly);
     }
 
@@ -36,16 +61,69 @@ public:
         close();
     }
 
+    // Publish new parameters of the playing signal (GUI thread).
+    // The sample rate of a playing signal cannot change, a new start() is needed for that.
+    void update(Signal &signal)
+    {
+        Parameters &params = m_params.writeBuffer();
+        params.tones.assign(signal.getBank());
+        params.sampleCount = signal.getSampleCount();
+        m_params.publish();
+    }
+
+    // Samples as they are played (reader side only)
+    RingBuffer<double> &monitor()
+    {
+        return m_monitor;
+    }
+
+    void setLooping(bool looping)
+    {
+        m_looping = looping;
+    }
+
+    bool isSequential() const override
+    {
+        return true;
+    }
+
 protected:
     qint64 readData(char *data, qint64 maxlen) override
     {
-        if (m_pos >= m_data.size())
-            return 0;
+        // Pick up the latest published parameters, unless still fading to previous ones
+        if (!m_synth.isRamping() && m_params.update())
+        {
+            m_synth.setTones(m_params.read().tones, RAMP_SAMPLES);
+            m_sampleCount = m_params.read().sampleCount;
+        }
 
-        qint64 len = qMin(maxlen, m_data.size() - m_pos);
-        memcpy(data, m_data.constData() + m_pos, len);
-        m_pos += len;
-        return len;
+        qint64 written = 0;
+        while (written + 2 <= maxlen) // 16-bit mono = 2 bytes per sample
+        {
+            size_t space = static_cast<size_t>((maxlen - written) / 2);
+
+            // Resampled output left over from the previous block goes first
+            if (m_pendingBegin < m_pendingEnd)
+            {
+                size_t count = qMin(space, m_pendingEnd - m_pendingBegin);
+                written += writeSamples(m_resampled.data() + m_pendingBegin, count, data + written);
+                m_pendingBegin += count;
+                continue;
+            }
+
+            size_t count = renderBlock(m_resampler ? m_resampler->inputFor(space) : space);
+            if (count == 0)
+                break;
+
+            if (!m_resampler)
+            {
+                written += writeSamples(m_chunk, count, data + written);
+                continue;
+            }
+            m_pendingBegin = 0;
+            m_pendingEnd = m_resampler->process(m_chunk, count, m_resampled.data());
+        }
+        return written;
     }
 
     qint64 writeData(const char *, qint64) override
@@ -55,12 +133,90 @@ protected:
 
     qint64 bytesAvailable() const override
     {
-        return m_data.size() - m_pos + QIODevice::bytesAvailable();
+        if (m_looping)
+            return std::numeric_limits<qint32>::max();
+        // A live update may have shortened the signal below the play position
+        size_t played = position();
+        qint64 remaining = played < m_sampleCount ? qint64(m_sampleCount - played) : 0;
+        if (m_resampler)
+            remaining = qint64((remaining + m_flushLeft) * m_resampler->ratio()) + qint64(m_pendingEnd - m_pendingBegin);
+        return 2 * remaining + QIODevice::bytesAvailable();
     }
 
 private:
-    QByteArray m_data;
-    qint64 m_pos;
+    // Synthesize up to count samples of the signal into m_chunk, return how many.
+    // Past the end of a resampled signal, zeros push the last samples through the filter
+    size_t renderBlock(size_t count)
+    {
+        count = qMin(count, SYNTH_BLOCK);
+        if (position() >= m_sampleCount)
+        {
+            if (m_looping && m_sampleCount > 0)
+            {
+                m_synth.restart();
+                m_sourcePosition = 0;
+            }
+            else
+            {
+                count = qMin(count, m_flushLeft);
+                std::fill(m_chunk, m_chunk + count, 0.0);
+                m_flushLeft -= count;
+                return count;
+            }
+        }
+
+        count = qMin(count, m_sampleCount - position());
+        if (m_source)
+        {
+            m_source->read(m_sourcePosition, m_sourcePosition + count, m_chunk);
+            m_sourcePosition += count;
+        }
+        else
+        {
+            m_synth.render(m_chunk, count);
+        }
+        m_monitor.push(m_chunk, count);
+        return count;
+    }
+
+    // Next sample of the signal to play
+    size_t position() const
+    {
+        return m_source ? m_sourcePosition : m_synth.getPosition();
+    }
+
+    // Convert to 16-bit little-endian PCM, return the bytes written
+    static qint64 writeSamples(const double *samples, size_t count, char *data)
+    {
+        encodePcm16(samples, count, reinterpret_cast<unsigned char *>(data));
+        return 2 * qint64(count);
+    }
+
+    struct Parameters
+    {
+        ToneSet tones;
+        size_t sampleCount = 0;
+    };
+
+    // Crossfade length when parameters change, about 10 ms at 44.1 kHz
+    static constexpr size_t RAMP_SAMPLES = 512;
+
+    // About 1.5 s at 44.1 kHz, plenty for a display polling at 60 Hz
+    static constexpr size_t MONITOR_SAMPLES = 65536;
+
+    TripleBuffer<Parameters> m_params;
+    RingBuffer<double> m_monitor;
+    StreamingSynth m_synth;
+    std::shared_ptr<const SampleSource> m_source; // Played instead of the synth for recordings
+    size_t m_sourcePosition = 0;
+    double m_chunk[SYNTH_BLOCK];
+    std::unique_ptr<Resampler> m_resampler;  // Only when the device rate differs
+    std::vector<double> m_resampled;         // Output of the last block at the device rate
+    size_t m_pendingBegin = 0;               // Part of it not written yet
+    size_t m_pendingEnd = 0;
+    size_t m_flushLeft = 0;                  // Zeros still to push after the end
+    size_t m_sampleCount = 0;
+    std::atomic<bool> m_looping{false};      // Set from the GUI thread while playing
 };
 
-#endif // SINEWAVEGENERATOR_H
\ No newline at end of file
+#endif // SINEWAVEGENERATOR_H
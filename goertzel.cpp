@@ -0,0 +1,92 @@
+#include "goertzel.h"
+#include "synth.h"
+#include "window.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+// Frequencies advanced together
+constexpr size_t LANES = 4;
+
+} // namespace
+
+void goertzel(const double *samples, size_t count, double sampleRate, const double *frequencies, size_t k,
+              std::complex<double> *out, const double *window)
+{
+    std::fill(out, out + k, std::complex<double>(0.0, 0.0));
+    if (count == 0 || sampleRate <= 0)
+        return;
+
+    for (size_t j0 = 0; j0 < k; j0 += LANES)
+    {
+        // Unused lanes run at 0 Hz and are dropped
+        double coeff[LANES], cw[LANES], sw[LANES];
+        for (size_t l = 0; l < LANES; l++)
+        {
+            double f = j0 + l < k ? frequencies[j0 + l] : 0.0;
+            double w = 2.0 * M_PI * f / sampleRate;
+            coeff[l] = 2.0 * std::cos(w);
+            cw[l] = std::cos(w);
+            sw[l] = std::sin(w);
+        }
+
+        std::complex<double> total[LANES] = {};
+        for (size_t block = 0; block < count; block += GOERTZEL_BLOCK)
+        {
+            const size_t length = std::min(GOERTZEL_BLOCK, count - block);
+            const double *x = samples + block;
+            const double *w = window ? window + block : nullptr;
+
+            // s[n] = x[n] + 2cos(w) s[n-1] - s[n-2]
+            double s1[LANES] = {}, s2[LANES] = {};
+            for (size_t n = 0; n < length; n++)
+            {
+                double value = w ? x[n] * w[n] : x[n];
+                for (size_t l = 0; l < LANES; l++)
+                {
+                    double s0 = value + coeff[l] * s1[l] - s2[l];
+                    s2[l] = s1[l];
+                    s1[l] = s0;
+                }
+            }
+
+            // Sum over the block relative to its first sample:
+            // exp(-i w (L-1)) * (s[L-1] - exp(-i w) s[L-2]), then shifted to the block's place
+            for (size_t l = 0; l < LANES && j0 + l < k; l++)
+            {
+                std::complex<double> y(s1[l] - cw[l] * s2[l], sw[l] * s2[l]);
+                double f = frequencies[j0 + l];
+                total[l] += y * std::polar(1.0, -phaseAt(f, 0.0, sampleRate, block + length - 1));
+            }
+        }
+
+        for (size_t l = 0; l < LANES && j0 + l < k; l++)
+            out[j0 + l] = total[l];
+    }
+}
+
+std::vector<ToneMeasurement> measureTones(const double *samples, size_t count, double sampleRate,
+                                          const std::vector<double> &frequencies)
+{
+    std::vector<ToneMeasurement> tones(frequencies.size());
+    if (count == 0 || frequencies.empty())
+        return tones;
+
+    // As long as the whole signal and used once, so not worth a place in the window cache
+    const Window hann(WindowType::Hann, count);
+    std::vector<std::complex<double>> sums(frequencies.size());
+    goertzel(samples, count, sampleRate, frequencies.data(), frequencies.size(), sums.data(), hann.data());
+
+    // A/2 * exp(i phase) * sum(window) from the positive frequency, except at DC
+    const double weight = hann.coherentGain() * count;
+    for (size_t j = 0; j < frequencies.size(); j++)
+    {
+        bool dc = frequencies[j] == 0.0;
+        tones[j].frequency = frequencies[j];
+        tones[j].amplitude = std::abs(sums[j]) / weight * (dc ? 1.0 : 2.0);
+        tones[j].phase = std::arg(sums[j]);
+    }
+    return tones;
+}
@@ -0,0 +1,33 @@
+#ifndef GOERTZEL_H
+#define GOERTZEL_H
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+// DFT of samples[0, count) at arbitrary frequencies (not only bin centres):
+// out[j] = sum over n of window[n] * samples[n] * exp(-2*pi*i * frequencies[j] * n / sampleRate).
+// Uses Goertzel's recurrence, one real multiply-add per sample and frequency, with the targets
+// run side by side four at a time so the inner loop vectorizes. O(count * k), so for a few
+// probes it is much cheaper than a full FFT. The recurrence is restarted every GOERTZEL_BLOCK
+// samples and the blocks are combined with exact phase factors, which keeps the error from
+// growing with the length of the signal. window may be null (rectangular).
+void goertzel(const double *samples, size_t count, double sampleRate, const double *frequencies, size_t k,
+              std::complex<double> *out, const double *window = nullptr);
+
+// Samples between two restarts of the recurrence
+constexpr size_t GOERTZEL_BLOCK = 4096;
+
+// Amplitude and phase of a cosine at a known frequency
+struct ToneMeasurement
+{
+    double frequency; // Hz
+    double amplitude;
+    double phase;     // Radians in (-pi, pi], at the first sample
+};
+
+// Measure A and phase of A*cos(2*pi*f*t + phase) at each of the frequencies.
+// Samples are weighted by a Hann window, so other tones a few bins away do not leak in
+std::vector<ToneMeasurement> measureTones(const double *samples, size_t count, double sampleRate,
+                                          const std::vector<double> &frequencies);
+
+#endif // GOERTZEL_H
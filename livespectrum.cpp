@@ -0,0 +1,77 @@
+#include "livespectrum.h"
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+
+// Between two drains of the ring buffer, about twice the display rate
+constexpr std::chrono::milliseconds INTERVAL(8);
+
+// Samples taken from the ring buffer at a time
+constexpr size_t CHUNK = 1024;
+
+} // namespace
+
+LiveSpectrum::LiveSpectrum(RingBuffer<double> &source, size_t frameSize)
+    : source(source), size(frameSize)
+{
+    // Every slot sized up front, the worker only overwrites them: taking each published
+    // slot as the reader rotates all three through the writer's place
+    for (int i = 0; i < 3; i++)
+    {
+        published.writeBuffer().assign(bins(), 0.0);
+        published.publish();
+        published.update();
+    }
+    worker = std::thread(&LiveSpectrum::run, this);
+}
+
+LiveSpectrum::~LiveSpectrum()
+{
+    stopping = true;
+    worker.join();
+}
+
+void LiveSpectrum::setActive(bool value)
+{
+    if (value && !active)
+        restart = true;
+    active = value;
+}
+
+// Worker thread
+void LiveSpectrum::run()
+{
+    SlidingDFT dft(size);
+    std::vector<double> chunk(CHUNK);
+    while (!stopping)
+    {
+        if (!active)
+        {
+            source.discard();
+        }
+        else
+        {
+            // Samples of the inactive time were dropped above, at most one interval's are left
+            if (restart.exchange(false))
+                dft.reset();
+
+            // What was there on waking up: a worker that falls behind still publishes
+            size_t pending = source.available();
+            bool added = pending > 0;
+            while (pending > 0)
+            {
+                size_t count = source.pop(chunk.data(), std::min(pending, chunk.size()));
+                dft.add(chunk.data(), count);
+                pending -= count;
+            }
+            if (added)
+            {
+                dft.amplitudes(published.writeBuffer().data());
+                published.publish();
+            }
+        }
+        std::this_thread::sleep_for(INTERVAL);
+    }
+}
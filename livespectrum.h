@@ -0,0 +1,54 @@
+#ifndef LIVESPECTRUM_H
+#define LIVESPECTRUM_H
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "ringbuffer.h"
+#include "slidingdft.h"
+#include "triplebuffer.h"
+
+// Spectrum of the samples coming out of a RingBuffer, kept up to date on a thread of its own.
+// The SlidingDFT costs O(bins) per sample, up to a few hundred million operations a second
+// for long frames, so it stays off the thread that draws. The worker is the ring buffer's only
+// reader: it drains it every INTERVAL, feeds the samples to the SlidingDFT and publishes the
+// amplitudes through a TripleBuffer, which the display takes the newest of at its own rate.
+// Nothing is allocated once running.
+class LiveSpectrum
+{
+public:
+    // Start reading source with frames of frameSize samples. source must outlive this object
+    LiveSpectrum(RingBuffer<double> &source, size_t frameSize);
+    // Stop and join the worker
+    ~LiveSpectrum();
+
+    LiveSpectrum(const LiveSpectrum &) = delete;
+    LiveSpectrum &operator=(const LiveSpectrum &) = delete;
+
+    // While inactive samples are dropped unread. Activating starts over from the samples
+    // that come next, as if only zeros had been seen before
+    void setActive(bool active);
+
+    size_t frameSize() const { return size; }
+    // Non-negative frequency bins, frameSize / 2 + 1
+    size_t bins() const { return size / 2 + 1; }
+
+    // Reader: take the newest published amplitudes (see SlidingDFT::amplitudes),
+    // false if nothing new was published since the last call
+    bool update() { return published.update(); }
+    const std::vector<double> &amplitudes() const { return published.read(); }
+
+private:
+    void run();
+
+    RingBuffer<double> &source;
+    const size_t size;
+    TripleBuffer<std::vector<double>> published;
+    std::atomic<bool> active{false};
+    std::atomic<bool> restart{false};
+    std::atomic<bool> stopping{false};
+    std::thread worker;
+};
+
+#endif // LIVESPECTRUM_H
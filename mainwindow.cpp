@@ -1,11 +1,79 @@
 #include "mainwindow.h"
 #include "./ui_mainwindow.h"
+#include "spectrum.h"
+#include "pcmfile.h"
+
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QInputDialog>
+#include <QLocale>
+#include <QMessageBox>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+// Shortest text that reads back as exactly value. QString::number's default of 6 significant
+// digits would round it, and the textChanged slots would store the rounded value
+QString exactText(double value)
+{
+    return QString::number(value, 'g', QLocale::FloatingPointShortest);
+}
+
+} // namespace
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent), ui(new Ui::MainWindow)
 {
     ui->setupUi(this);
     this->setFixedSize(this->size().width(), this->size().height());
+
+    // Samples and DFT are computed off the GUI thread
+    analyzer = new SignalAnalyzer(this);
+    AnalysisSettings settings;
+    settings.window = static_cast<WindowType>(ui->windowType->currentIndex());
+    settings.frameSize = ui->frameSize->currentText().toULong();
+    settings.hop = settings.frameSize / 4;
+    analyzer->setSettings(settings);
+    connect(analyzer, &SignalAnalyzer::progress, ui->analysisProgress, &QProgressBar::setValue);
+    connect(analyzer, &SignalAnalyzer::cancelled, ui->analysisProgress, &QProgressBar::reset);
+    connect(analyzer, &SignalAnalyzer::finished, this, &MainWindow::onAnalysisFinished);
+
+    // Edits re-plot once they have settled, not on every keystroke
+    replotTimer = new QTimer(this);
+    replotTimer->setSingleShot(true);
+    replotTimer->setInterval(300);
+    connect(replotTimer, &QTimer::timeout, this, [this] {
+        int signalIndex = getCurrentSignalIndex();
+        if (signalIndex < 0)
+            return;
+        bool edited = this->signalList[signalIndex].getGeneration(Signal::ContentChange) != plottedGeneration;
+        bool resettled = !shownResult || shownResult->settings != analyzer->settings();
+        if (edited || resettled)
+            updateCharts();
+    });
+
+    // Live spectrum of the playing sound, at display rate
+    liveTimer = new QTimer(this);
+    liveTimer->setInterval(16);
+    connect(liveTimer, &QTimer::timeout, this, &MainWindow::updateLiveSpectrum);
+
+    // Persistent charts, each result only replaces the plotted points
+    setupChartPanel(signalPanel, ui->signal_widget, true);
+    setupChartPanel(dftPanel, ui->dft_widget, false);
+    dftPanel.axisX->setLabelFormat("%.0f");
+    dftPanel.axisX->setTitleText("Hz");
+    setupChartPanel(filterPanel, ui->filter_widget, false);
+    filterPanel.axisX->setLabelFormat("%.0f");
+    filterPanel.axisX->setTitleText("Hz");
+    filterPanel.axisY->setTitleText("dB");
+    connect(ui->decimationMode, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this] {
+        refreshChartPanel(signalPanel);
+        refreshChartPanel(dftPanel);
+        refreshChartPanel(filterPanel);
+    });
     
     // Load signal data from JSON file
     QVariant input_signals = readJsonProperty(":/data/data.json", "signals");
@@ -67,133 +135,283 @@ int MainWindow::getCurrentOvertoneIndex() const
 }
 
 // ---------- Chart plotting
-void MainWindow::updateSignalCharts() const
-{
-    int signalIndex = getCurrentSignalIndex();
 
-    const Signal &signal = this->signalList[signalIndex];
-    QtCharts::QLineSeries *series = new QtCharts::QSplineSeries();
+void MainWindow::setupChartPanel(ChartPanel &panel, QWidget *widget, bool dark)
+{
+    // Created once, later results only replace the points
+    panel.chart = new QtCharts::QChart();
+    panel.chart->legend()->hide();
+    panel.chart->setBackgroundVisible(false);
+    panel.chart->setMargins(QMargins(0, 0, 0, 0));
+    if (dark)
+        panel.chart->setTheme(QtCharts::QChart::ChartThemeDark);
+
+    // Straight lines: a spline through a decimated envelope would overshoot
+    panel.series = new QtCharts::QLineSeries();
+    panel.chart->addSeries(panel.series);
+
+    panel.axisX = new QtCharts::QValueAxis();
+    panel.axisX->setLabelFormat("%d");
+    panel.axisY = new QtCharts::QValueAxis();
+    panel.chart->addAxis(panel.axisX, Qt::AlignBottom);
+    panel.chart->addAxis(panel.axisY, Qt::AlignLeft);
+    panel.series->attachAxis(panel.axisX);
+    panel.series->attachAxis(panel.axisY);
+
+    // Drag to zoom in, right click to zoom out
+    panel.view = new QtCharts::QChartView(panel.chart);
+    panel.view->setRenderHint(QPainter::Antialiasing, true);
+    panel.view->setRubberBand(QtCharts::QChartView::HorizontalRubberBand);
+
+    if (!widget->layout())
+        widget->setLayout(new QHBoxLayout());
+    widget->layout()->addWidget(panel.view);
+
+    // Zooming and resizing decimate the visible range again
+    connect(panel.axisX, &QtCharts::QValueAxis::rangeChanged, this, [this, &panel] { refreshChartPanel(panel); });
+    connect(panel.chart, &QtCharts::QChart::plotAreaChanged, this, [this, &panel] { refreshChartPanel(panel); });
+}
 
-    // Clear previous series
-    for (auto *chart : ui->signal_widget->findChildren<QtCharts::QChart *>())
+void MainWindow::showChartData(ChartPanel &panel, std::shared_ptr<const SampleSource> values,
+                               std::shared_ptr<const MinMaxPyramid> pyramid, double xStep)
+{
+    panel.values = std::move(values);
+    panel.pyramid = std::move(pyramid);
+    panel.xStep = xStep;
+    if (panel.values->size() == 0)
     {
-        chart->removeAllSeries();
+        panel.series->clear();
+        return;
     }
 
-    std::vector<double> samples = signal.getSamples();
+    // Values not in memory are only ever seen through the pyramid
+    double lowest, highest;
+    if (const double *data = panel.values->data())
+    {
+        auto [low, high] = std::minmax_element(data, data + panel.values->size());
+        lowest = *low;
+        highest = *high;
+    }
+    else if (panel.pyramid)
+    {
+        lowest = panel.pyramid->minimum();
+        highest = panel.pyramid->maximum();
+    }
+    else
+    {
+        lowest = -1.0; // Full scale of a recording
+        highest = 1.0;
+    }
+    double margin = std::max(0.05 * (highest - lowest), 1e-9);
+    panel.axisY->setRange(lowest - margin, highest + margin);
 
-    if (samples.empty())
+    // New data starts zoomed out, refreshed once below
     {
-        qWarning() << "No samples available for signal" << signal.name;
-        return; // No samples to plot
+        const QSignalBlocker blocker(panel.axisX);
+        panel.chart->zoomReset();
+        panel.axisX->setRange(0, (panel.values->size() - 1) * xStep);
     }
+    refreshChartPanel(panel);
+}
+
+void MainWindow::showChartData(ChartPanel &panel, std::shared_ptr<const std::vector<double>> values,
+                               std::shared_ptr<const MinMaxPyramid> pyramid, double xStep)
+{
+    showChartData(panel, std::make_shared<BufferSource>(std::move(values), 0), std::move(pyramid), xStep);
+}
 
-    // Populate the series with samples
-    for (size_t i = 0; i < samples.size(); ++i)
+void MainWindow::replaceChartData(ChartPanel &panel, std::shared_ptr<const std::vector<double>> values)
+{
+    panel.values = std::make_shared<BufferSource>(std::move(values), 0);
+    if (panel.values->size() == 0)
     {
-        series->append(i, samples[i]);
+        panel.series->clear();
+        return;
     }
 
-    // Add the new series to the chart
-    QtCharts::QChart *chart = new QtCharts::QChart();
-    chart->addSeries(series);
-    chart->legend()->hide();
-    chart->setBackgroundVisible(false);
-    chart->setMargins(QMargins(0, 0, 0, 0));
-    // chart->createDefaultAxes();
-    chart->setAnimationOptions(QtCharts::QChart::SeriesAnimations);
-    chart->setTheme(QtCharts::QChart::ChartThemeDark);
-    ui->signal_chartLbl->setText(signal.name);
-    // chart->setTitle(signal.name);
+    // The y axis only grows, for a peak above it
+    const double *data = panel.values->data();
+    double highest = *std::max_element(data, data + panel.values->size());
+    if (highest > panel.axisY->max())
+        panel.axisY->setMax(highest + 0.05 * (highest - panel.axisY->min()));
+    refreshChartPanel(panel);
+}
+
+void MainWindow::refreshChartPanel(ChartPanel &panel) const
+{
+    if (!panel.values || panel.values->size() == 0)
+        return;
+
+    // Only the visible range goes to the series, at about two points per pixel
+    const SampleSource &values = *panel.values;
+    size_t begin = static_cast<size_t>(std::max(0.0, std::floor(panel.axisX->min() / panel.xStep)));
+    size_t end = static_cast<size_t>(std::max(0.0, std::ceil(panel.axisX->max() / panel.xStep) + 1));
+    end = std::min(end, values.size());
+    begin = std::min(begin, end);
+
+    size_t pixels = static_cast<size_t>(std::max(panel.chart->plotArea().width(), 1.0));
+    Decimation mode = ui->decimationMode->currentIndex() == 1 ? Decimation::LTTB : Decimation::MinMax;
 
-    QtCharts::QChartView *chartView = new QtCharts::QChartView(chart);
-    chartView->setRenderHint(QPainter::Antialiasing, true);
+    // LTTB reads the visible range; of values that are not in memory only a limited stretch,
+    // wider ranges fall back to the pyramid's envelope
+    constexpr size_t LTTB_READ_LIMIT = size_t(1) << 22;
+    bool havePyramid = panel.pyramid && panel.pyramid->size() == values.size();
+    if (!values.data() && havePyramid && end - begin > LTTB_READ_LIMIT)
+        mode = Decimation::MinMax;
 
-    // Add the chartView to the signal_widget through its layout
-    if (!(ui->signal_widget->layout()))
+    // The pyramid serves the envelope of any range in O(pixels)
+    std::vector<PlotPoint> points;
+    if (mode == Decimation::MinMax && havePyramid)
     {
-        ui->signal_widget->setLayout(new QHBoxLayout());
-        ui->signal_widget->layout()->addWidget(chartView);
+        panel.pyramid->envelope(values, begin, end, pixels, points);
+    }
+    else if (const double *data = values.data())
+    {
+        decimate(mode, data, begin, end, pixels, points);
     }
     else
     {
-        // Remove all existing widgets from the layout before adding
-        QLayout *layout = ui->signal_widget->layout();
-        QLayoutItem *child;
-        while ((child = layout->takeAt(0)) != nullptr)
-        {
-            if (child->widget())
-                child->widget()->deleteLater();
-            delete child;
-        }
-        layout->addWidget(chartView);
+        std::vector<double> visible(end - begin);
+        values.read(begin, end, visible.data());
+        decimate(mode, visible.data(), 0, visible.size(), pixels, points);
+        for (PlotPoint &point : points)
+            point.x += static_cast<double>(begin);
     }
+
+    // One bulk replace, appending point by point repaints and reallocates every time
+    QVector<QPointF> plotted;
+    plotted.reserve(static_cast<int>(points.size()));
+    for (const PlotPoint &point : points)
+        plotted.append(QPointF(point.x * panel.xStep, point.y));
+    panel.series->replace(plotted);
 }
 
-void MainWindow::updateDFTCharts() const
+void MainWindow::updateSignalCharts(std::shared_ptr<const AnalysisResult> result)
 {
-    int signalIndex = getCurrentSignalIndex();
-    const Signal &signal = this->signalList[signalIndex];
+    const Signal &signal = result->signal;
+    if (result->samples->size() == 0)
+        qWarning() << "No samples available for signal" << signal.name;
 
-    // Clear previous DFT charts
-    for (auto *chart : ui->dft_widget->findChildren<QtCharts::QChart *>())
-    {
-        chart->removeAllSeries();
-    }
+    bool filtered = result->settings.filter.design != FilterDesign::None;
+    ui->signal_chartLbl->setText(filtered ? signal.name + " (filtered)" : signal.name);
 
-    // Get the DFT coefficients
-    std::vector<std::complex<double>> dftCoefficients = signal.getDFT();
+    // Shares ownership of the result, zooming decimates the samples again
+    showChartData(signalPanel, result->samples, std::shared_ptr<const MinMaxPyramid>(result, &result->pyramid));
+}
 
-    if (dftCoefficients.empty())
-    {
-        qWarning() << "No DFT coefficients available for signal" << signal.name;
-        return; // No coefficients to plot
-    }
+void MainWindow::updateDFTCharts(std::shared_ptr<const AnalysisResult> result)
+{
+    const Signal &signal = result->signal;
 
-    QtCharts::QLineSeries *series = new QtCharts::QSplineSeries();
+    // The live spectrum replaces the chart on its own while playing
+    if (ui->spectrumMode->currentIndex() == 2 && liveTimer->isActive())
+        return;
+    livePlotted = false;
 
-    // Populate the series with DFT coefficients
-    for (size_t i = 0; i < dftCoefficients.size(); ++i)
+    if (ui->spectrumMode->currentIndex() == 1)
     {
-        series->append(i, std::abs(dftCoefficients[i]));
+        // Welch PSD: averaged over the whole signal, in dB
+        if (result->psd.empty())
+            qWarning() << "No PSD available for signal" << signal.name;
+        dftPanel.axisY->setTitleText("dB/Hz");
+        showChartData(dftPanel, std::shared_ptr<const std::vector<double>>(result, &result->psd), nullptr,
+                      result->psdBinWidth);
+        return;
     }
 
-    // Create a new chart and add the series
-    QtCharts::QChart *chart = new QtCharts::QChart();
-    chart->addSeries(series);
-    chart->legend()->hide();
-    chart->setBackgroundVisible(false);
-    chart->setMargins(QMargins(0, 0, 0, 0));
+    // DFT coefficients, the upper half of a real signal's spectrum mirrors the lower one
+    const std::vector<std::complex<double>> &dftCoefficients = result->spectrum;
+    if (dftCoefficients.empty())
+        qWarning() << "No DFT coefficients available for signal" << signal.name;
+
+    // Shown as sine amplitudes, so the peaks read the same whatever the window
+    auto magnitudes = std::make_shared<std::vector<double>>(
+        sineAmplitudes(dftCoefficients, static_cast<size_t>(signal.sampleRate), result->amplitudeScale));
 
-    QtCharts::QChartView *chartView = new QtCharts::QChartView(chart);
-    chartView->setRenderHint(QPainter::Antialiasing, true);
+    // The DFT spans sampleRate samples, so its bins are 1 Hz apart
+    dftPanel.axisY->setTitleText("Amplitude");
+    showChartData(dftPanel, magnitudes, nullptr, 1.0);
+}
+
+void MainWindow::updateToneTable(std::shared_ptr<const AnalysisResult> result)
+{
+    // Recordings have no measurements
+    const std::vector<overtone> &overtones = result->signal.overtones;
+    const size_t rows = std::min(overtones.size(), result->tones.size());
+    ui->overtoneTable->setRowCount(static_cast<int>(rows));
+
+    for (size_t i = 0; i < rows; i++)
+    {
+        const overtone &ot = overtones[i];
+        const ToneMeasurement &tone = result->tones[i];
+        // Set phase in the same (-pi, pi] range as the measured one
+        double phase = std::remainder(ot.phase, 2.0 * M_PI);
+
+        int row = static_cast<int>(i);
+        ui->overtoneTable->setItem(row, 0, new QTableWidgetItem(ot.name));
+        ui->overtoneTable->setItem(row, 1, new QTableWidgetItem(QString::number(tone.frequency)));
+        ui->overtoneTable->setItem(row, 2, new QTableWidgetItem(
+            QString("%1 (%2)").arg(tone.amplitude, 0, 'f', 4).arg(ot.amplitude, 0, 'f', 4)));
+        ui->overtoneTable->setItem(row, 3, new QTableWidgetItem(
+            QString("%1 (%2)").arg(tone.phase, 0, 'f', 4).arg(phase, 0, 'f', 4)));
+    }
+}
 
-    // Add the chartView to the dft_widget through its layout
-    if (!(ui->dft_widget->layout()))
+void MainWindow::updateLiveSpectrum()
+{
+    if (!generator || !liveSpectrum)
     {
-        ui->dft_widget->setLayout(new QHBoxLayout());
-        // ui->dft_widget->setFixedSize(QSize(400, 300));
-        ui->dft_widget->layout()->addWidget(chartView);
+        liveTimer->stop();
+        return;
     }
-    else
+
+    // The worker drops the samples while another view is shown
+    if (ui->spectrumMode->currentIndex() != 2 || !liveSpectrum->update())
+        return;
+    auto amplitudes = std::make_shared<std::vector<double>>(liveSpectrum->amplitudes());
+
+    // Zoomed out on the first frame, later frames keep the user's zoom
+    if (livePlotted)
     {
-        // Remove all existing widgets from the layout before adding
-        QLayout *layout = ui->dft_widget->layout();
-        QLayoutItem *child;
-        while ((child = layout->takeAt(0)) != nullptr)
-        {
-            if (child->widget())
-                child->widget()->deleteLater();
-            delete child;
-        }
-        layout->addWidget(chartView);
+        replaceChartData(dftPanel, amplitudes);
+        return;
     }
+    dftPanel.axisY->setTitleText("Amplitude");
+    showChartData(dftPanel, amplitudes, nullptr, liveSampleRate / liveSpectrum->frameSize());
+    livePlotted = true;
+}
+
+void MainWindow::updateCharts()
+{
+    int signalIndex = getCurrentSignalIndex();
+    if (signalIndex < 0)
+        return;
+
+    // Restarts the analysis if one is already running
+    const Signal &signal = this->signalList[signalIndex];
+    requestedGeneration = signal.getGeneration(Signal::ContentChange);
+    analyzer->analyze(signal);
 }
 
-void MainWindow::updateCharts() const
+void MainWindow::onAnalysisFinished(std::shared_ptr<const AnalysisResult> result)
 {
-    updateSignalCharts();
-    updateDFTCharts();
+    // Only the latest request is ever delivered
+    plottedGeneration = requestedGeneration;
+    shownResult = result;
+    updateSignalCharts(result);
+    updateDFTCharts(result);
+    updateToneTable(result);
+    showChartData(filterPanel, std::shared_ptr<const std::vector<double>>(result, &result->response), nullptr,
+                  result->responseStep);
+    ui->spectrogram->setSpectrogram(std::shared_ptr<const Spectrogram>(result, &result->spectrogram));
+
+    // How often switching signals and settings is served from the cache
+    const AnalysisCache &cache = analyzer->cache();
+    ui->analysisProgress->setToolTip(QString("Analysis cache: %1 hits, %2 misses, %3 results in %4 MiB")
+                                         .arg(cache.hits())
+                                         .arg(cache.misses())
+                                         .arg(cache.size())
+                                         .arg(cache.memoryUsage() / (1024.0 * 1024.0), 0, 'f', 1));
 }
 
 void MainWindow::on_graphBtn_clicked()
@@ -222,12 +440,16 @@ void MainWindow::on_playBtn_clicked()
         delete audio;
         audio = nullptr;
     }
+    // Reads the generator's monitor until joined
+    liveSpectrum.reset();
     if (generator)
     {
         generator->stop();
         delete generator;
         generator = nullptr;
+        playingIndex = -1;
     }
+    liveTimer->stop();
 
     // Check if any audio output device is available
     QList<QAudioDeviceInfo> devices = QAudioDeviceInfo::availableDevices(QAudio::AudioOutput);
@@ -245,17 +467,184 @@ void MainWindow::on_playBtn_clicked()
     format.setByteOrder(QAudioFormat::LittleEndian);
     format.setSampleType(QAudioFormat::SignedInt);
 
-    if (!QAudioDeviceInfo::defaultOutputDevice().isFormatSupported(format))
-    {
-        qWarning() << "Raw audio format not supported by backend";
-        return;
+    // Rates the device does not take are resampled to the closest one it does
+    QAudioDeviceInfo device = QAudioDeviceInfo::defaultOutputDevice();
+    int outputRate = 0;
+    if (!device.isFormatSupported(format))
+    {
+        QAudioFormat nearest = device.nearestFormat(format);
+        nearest.setChannelCount(1);
+        nearest.setSampleSize(16);
+        nearest.setCodec("audio/pcm");
+        nearest.setByteOrder(QAudioFormat::LittleEndian);
+        nearest.setSampleType(QAudioFormat::SignedInt);
+        if (nearest.sampleRate() <= 0 || !device.isFormatSupported(nearest))
+        {
+            qWarning() << "Raw audio format not supported by backend";
+            return;
+        }
+        outputRate = nearest.sampleRate();
+        format = nearest;
     }
 
     generator = new SineWaveGenerator(this);
-    generator->start(this->signalList[signalIndex]);
+    generator->start(this->signalList[signalIndex], ui->loopCheck->isChecked(), outputRate);
+    playingIndex = signalIndex;
+    playingGeneration = this->signalList[signalIndex].getGeneration(Signal::ContentChange);
 
     audio = new QAudioOutput(format, this);
     audio->start(generator);
+
+    // Frames as long as the spectrogram's
+    liveSpectrum = std::make_unique<LiveSpectrum>(generator->monitor(), analyzer->settings().frameSize);
+    liveSpectrum->setActive(ui->spectrumMode->currentIndex() == 2);
+    liveSampleRate = this->signalList[signalIndex].sampleRate;
+    livePlotted = false;
+    liveTimer->start();
+}
+
+void MainWindow::on_loopCheck_toggled(bool checked)
+{
+    // Takes effect on the playing signal too
+    if (generator)
+        generator->setLooping(checked);
+}
+
+void MainWindow::on_windowType_currentIndexChanged(int index)
+{
+    // Items are in the order of WindowType
+    AnalysisSettings settings = analyzer->settings();
+    settings.window = static_cast<WindowType>(index);
+    analyzer->setSettings(settings);
+    if (!this->signalList.empty())
+        updateCharts();
+}
+
+void MainWindow::on_frameSize_currentIndexChanged(int)
+{
+    // Frames overlap by 75%, enough for the Hann-like windows to cover every sample evenly
+    AnalysisSettings settings = analyzer->settings();
+    settings.frameSize = ui->frameSize->currentText().toULong();
+    settings.hop = settings.frameSize / 4;
+    analyzer->setSettings(settings);
+    if (liveSpectrum)
+    {
+        // One reader at a time on the monitor: the old worker is joined first
+        bool active = ui->spectrumMode->currentIndex() == 2;
+        liveSpectrum.reset();
+        liveSpectrum = std::make_unique<LiveSpectrum>(generator->monitor(), settings.frameSize);
+        liveSpectrum->setActive(active);
+        livePlotted = false;
+    }
+    if (!this->signalList.empty())
+        updateCharts();
+}
+
+void MainWindow::on_spectrumMode_currentIndexChanged(int index)
+{
+    // The live spectrum starts over from what plays next
+    if (liveSpectrum)
+        liveSpectrum->setActive(index == 2);
+
+    // DFT and PSD are part of every result, nothing to recompute
+    if (shownResult)
+        updateDFTCharts(shownResult);
+}
+
+void MainWindow::on_filterDesign_currentIndexChanged(int index)
+{
+    // A usual length for each design, IIR orders beyond about 10 gain little
+    bool iir = index == static_cast<int>(FilterDesign::IIR);
+    WITH_NO_SIGNALS(filterOrder, setMaximum(iir ? static_cast<int>(MAX_IIR_ORDER) : 65535));
+    if (index == static_cast<int>(FilterDesign::FIR))
+        WITH_NO_SIGNALS(filterOrder, setValue(101));
+    else if (iir)
+        WITH_NO_SIGNALS(filterOrder, setValue(4));
+    filterEdited();
+}
+
+void MainWindow::on_filterType_currentIndexChanged(int)
+{
+    filterEdited();
+}
+
+void MainWindow::on_filterLow_editingFinished()
+{
+    filterEdited();
+}
+
+void MainWindow::on_filterHigh_editingFinished()
+{
+    filterEdited();
+}
+
+void MainWindow::on_filterOrder_valueChanged(int)
+{
+    filterEdited();
+}
+
+void MainWindow::filterEdited()
+{
+    // Items are in the order of FilterDesign and FilterType
+    FilterSpec filter;
+    filter.design = static_cast<FilterDesign>(ui->filterDesign->currentIndex());
+    filter.type = static_cast<FilterType>(ui->filterType->currentIndex());
+    filter.low = ui->filterLow->text().toDouble();
+    filter.high = ui->filterHigh->text().toDouble();
+    filter.order = static_cast<size_t>(ui->filterOrder->value());
+
+    AnalysisSettings settings = analyzer->settings();
+    if (settings.filter == filter)
+        return;
+    settings.filter = filter;
+    analyzer->setSettings(settings);
+
+    // Stepping through orders or cutoffs analyses once they have settled, like signal edits
+    analyzer->cancel();
+    replotTimer->start();
+}
+
+void MainWindow::on_openGLCheck_toggled(bool checked)
+{
+    // Drawn by the GPU, for large datasets (no antialiasing in this mode)
+    signalPanel.series->setUseOpenGL(checked);
+    dftPanel.series->setUseOpenGL(checked);
+    filterPanel.series->setUseOpenGL(checked);
+}
+
+void MainWindow::updatePlayback(int signalIndex)
+{
+    if (!generator || signalIndex != playingIndex)
+        return;
+
+    // Heard within a few milliseconds, the generator crossfades to the new parameters
+    Signal &signal = this->signalList[signalIndex];
+    quint64 generation = signal.getGeneration(Signal::ContentChange);
+    if (generation == playingGeneration)
+        return;
+    playingGeneration = generation;
+    generator->update(signal);
+}
+
+void MainWindow::signalEdited(int changes)
+{
+    int signalIndex = getCurrentSignalIndex();
+    if (signalIndex < 0)
+        return;
+    Signal &signal = this->signalList[signalIndex];
+    signal.changed(changes);
+
+    // A rename only shows in the chart title
+    if ((changes & Signal::NameChange) && signal.getGeneration(Signal::ContentChange) == plottedGeneration)
+        ui->signal_chartLbl->setText(signal.name);
+
+    if (changes & Signal::ContentChange)
+    {
+        // The running analysis uses the old values
+        analyzer->cancel();
+        updatePlayback(signalIndex);
+        replotTimer->start(); // Restarted by every keystroke
+    }
 }
 
 // ---------- Signal management
@@ -283,6 +672,55 @@ void MainWindow::on_signal_newBtn_clicked()
     on_signal_currentIndexChanged(this->signalList.size() - 1);
 }
 
+void MainWindow::on_importBtn_clicked()
+{
+    QString path = QFileDialog::getOpenFileName(this, "Import recording", QString(),
+                                                "Recordings (*.wav *.raw *.pcm);;All files (*)");
+    if (path.isEmpty())
+        return;
+
+    QString error;
+    std::shared_ptr<PcmFile> file;
+    if (path.endsWith(".wav", Qt::CaseInsensitive))
+    {
+        file = PcmFile::openWav(path, error);
+    }
+    else
+    {
+        // Headerless: the layout has to be given, items in the order of SampleFormat
+        bool ok = false;
+        QStringList formats = {"16-bit integer", "24-bit integer", "32-bit float"};
+        QString format = QInputDialog::getItem(this, "Raw PCM", "Sample format", formats, 0, false, &ok);
+        if (!ok)
+            return;
+        int sampleRate = QInputDialog::getInt(this, "Raw PCM", "Sample rate, Hz", 44100, 1, 10000000, 1, &ok);
+        if (!ok)
+            return;
+        int channels = QInputDialog::getInt(this, "Raw PCM", "Channels", 1, 1, 64, 1, &ok);
+        if (!ok)
+            return;
+        file = PcmFile::openRaw(path, static_cast<SampleFormat>(formats.indexOf(format)), sampleRate, channels,
+                                error);
+    }
+    if (!file)
+    {
+        qWarning() << "Cannot import" << path << ":" << error;
+        QMessageBox::warning(this, "Import", QString("Cannot import %1:\n%2").arg(path, error));
+        return;
+    }
+
+    // Mapped, not loaded: the samples are decoded as they are read
+    Signal recording(QFileInfo(path).completeBaseName(), file->sampleRate(),
+                     static_cast<double>(file->size()) / file->sampleRate(), {});
+    recording.source = file;
+    recording.changed(Signal::ContentChange);
+    this->signalList.push_back(recording);
+    WITH_NO_SIGNALS(signal, addItem(recording.name));
+    WITH_NO_SIGNALS(signal, setCurrentIndex(static_cast<int>(this->signalList.size()) - 1));
+    on_signal_currentIndexChanged(static_cast<int>(this->signalList.size()) - 1);
+    updateCharts();
+}
+
 void MainWindow::on_signal_removeBtn_clicked()
 {
     int currentIndex = ui->signal->currentIndex();
@@ -295,6 +733,12 @@ void MainWindow::on_signal_removeBtn_clicked()
     // Remove the signal from the list
     this->signalList.erase(this->signalList.begin() + currentIndex);
 
+    // Keep playing, but edits no longer apply to the removed signal
+    if (playingIndex == currentIndex)
+        playingIndex = -1;
+    else if (playingIndex > currentIndex)
+        playingIndex--;
+
     // Update the signal dropdown
     ui->signal->blockSignals(true);
     ui->signal->removeItem(currentIndex);
@@ -318,14 +762,20 @@ void MainWindow::on_signal_currentIndexChanged(int index)
         qWarning() << "Invalid signal index" << index;
         return;
     }
+    // Results of another signal are not wanted anymore
+    analyzer->cancel();
+
     // Clear previous signal properties (and overtones)
     clearSignalProperties();
 
     const Signal &signal = this->signalList[index];
     // Update the signal name, duration, and sample rate
     ui->signal_name->setText(signal.name);
-    ui->signal_duration->setText(QString::number(signal.duration));
+    ui->signal_duration->setText(exactText(signal.duration));
     ui->signal_sampleRate->setText(QString::number(signal.sampleRate));
+    // A recording's sampling is the file's
+    ui->signal_duration->setEnabled(!signal.source);
+    ui->signal_sampleRate->setEnabled(!signal.source);
 
     // Clear previous overtone data
     ui->overtone->blockSignals(true);
@@ -343,6 +793,10 @@ void MainWindow::on_signal_currentIndexChanged(int index)
     {
         on_overtone_currentIndexChanged(0);
     }
+
+    // Analysed before: plotted at once from the cache
+    if (analyzer->cache().contains(signal, analyzer->settings()))
+        updateCharts();
     // on_overtone_currentIndexChanged(0);
 }
 
@@ -350,7 +804,10 @@ void MainWindow::on_signal_currentIndexChanged(int index)
 void MainWindow::on_signal_name_textChanged(const QString &arg1)
 {
     Signal &signal = this->signalList[getCurrentSignalIndex()];
+    if (signal.name == arg1)
+        return;
     signal.name = arg1;
+    signalEdited(Signal::NameChange);
 
     // Update the signal dropdown to reflect the new name
     ui->signal->blockSignals(true);
@@ -362,7 +819,10 @@ void MainWindow::on_signal_duration_textChanged(const QString &arg1)
 {
     Signal &signal = this->signalList[getCurrentSignalIndex()];
     double duration = arg1.toDouble();
+    if (signal.duration == duration)
+        return;
     signal.duration = duration;
+    signalEdited(Signal::SamplingChange);
 }
 
 void MainWindow::on_signal_sampleRate_textChanged(const QString &arg1)
@@ -370,7 +830,10 @@ void MainWindow::on_signal_sampleRate_textChanged(const QString &arg1)
     // Update the value
     Signal &signal = this->signalList[getCurrentSignalIndex()];
     int sampleRate = arg1.toInt();
+    if (signal.sampleRate == sampleRate)
+        return;
     signal.sampleRate = sampleRate;
+    signalEdited(Signal::SamplingChange);
 }
 
 // ---------- Overtone management
@@ -385,6 +848,7 @@ void MainWindow::on_overtone_newBtn_clicked()
 
     // Add the new overtone to the signal's overtone list
     signal.overtones.push_back(newOvertone);
+    signalEdited(Signal::SynthesisChange);
 
     // Update the overtone dropdown
     ui->overtone->blockSignals(true);
@@ -416,6 +880,7 @@ void MainWindow::on_overtone_removeBtn_clicked()
     // Remove the overtone from the signal's overtone list
     Signal &signal = this->signalList[getCurrentSignalIndex()];
     signal.overtones.erase(signal.overtones.begin() + currentIndex);
+    signalEdited(Signal::SynthesisChange);
 
     // Update the overtone dropdown
     ui->overtone->blockSignals(true);
@@ -450,9 +915,9 @@ void MainWindow::on_overtone_currentIndexChanged(int index)
     {
         const overtone &ot = signal.overtones[index];
         ui->overtone_name->setText(ot.name);
-        ui->overtone_amplitude->setText(QString::number(ot.amplitude));
-        ui->overtone_frequency->setText(QString::number(ot.frequency));
-        ui->overtone_phase->setText(QString::number(ot.phase));
+        ui->overtone_amplitude->setText(exactText(ot.amplitude));
+        ui->overtone_frequency->setText(exactText(ot.frequency));
+        ui->overtone_phase->setText(exactText(ot.phase));
     }
 }
 
@@ -464,7 +929,10 @@ void MainWindow::on_overtone_name_textChanged(const QString &arg1)
     overtone &overtone = signal.overtones[getCurrentOvertoneIndex()];
 
     // Update the value
+    if (overtone.name == arg1)
+        return;
     overtone.name = arg1;
+    signalEdited(Signal::NameChange);
 
     // Update the overtone dropdown to reflect the new name
     ui->overtone->blockSignals(true);
@@ -479,7 +947,10 @@ void MainWindow::on_overtone_amplitude_textChanged(const QString &arg1)
     overtone &overtone = signal.overtones[getCurrentOvertoneIndex()];
 
     double amplitude = arg1.toDouble();
+    if (overtone.amplitude == amplitude)
+        return;
     overtone.amplitude = amplitude;
+    signalEdited(Signal::SynthesisChange);
 }
 
 void MainWindow::on_overtone_frequency_textChanged(const QString &arg1)
@@ -489,7 +960,10 @@ void MainWindow::on_overtone_frequency_textChanged(const QString &arg1)
     overtone &overtone = signal.overtones[getCurrentOvertoneIndex()];
 
     double frequency = arg1.toDouble();
+    if (overtone.frequency == frequency)
+        return;
     overtone.frequency = frequency;
+    signalEdited(Signal::SynthesisChange);
 }
 
 void MainWindow::on_overtone_phase_textChanged(const QString &arg1)
@@ -499,5 +973,8 @@ void MainWindow::on_overtone_phase_textChanged(const QString &arg1)
     overtone &overtone = signal.overtones[getCurrentOvertoneIndex()];
 
     double phase = arg1.toDouble();
+    if (overtone.phase == phase)
+        return;
     overtone.phase = phase;
+    signalEdited(Signal::SynthesisChange);
 }
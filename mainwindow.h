@@ -7,14 +7,19 @@
 #include "signal.h"
 #include "utils.h"
 #include "generator.h"
+#include "analyzer.h"
+#include "decimate.h"
+#include "livespectrum.h"
 
 #include <QChart>
 #include <QChartView>
-#include <QSplineSeries>
+#include <QLineSeries>
+#include <QValueAxis>
 #include <QAudioOutput>
 #include <QBuffer>
 #include <QAudioDecoder>
 #include <QIODevice>
+#include <QTimer>
 
 #define WITH_NO_SIGNALS(var, inside) \
     do { \
@@ -46,9 +51,19 @@ public:
     void clearSignalProperties() const;
     void clearOvertones() const;
 
-    void updateSignalCharts() const;
-    void updateDFTCharts() const;
-    void updateCharts() const;
+    void updateSignalCharts(std::shared_ptr<const AnalysisResult> result);
+    void updateDFTCharts(std::shared_ptr<const AnalysisResult> result);
+    // Measured amplitude and phase of each overtone next to the set ones
+    void updateToneTable(std::shared_ptr<const AnalysisResult> result);
+    // Feed the samples played since the last tick to the sliding DFT and plot it
+    void updateLiveSpectrum();
+    // Start analysing the current signal, the charts update when the result arrives
+    void updateCharts();
+    // Record an edit of the current signal (Signal::Change flags): content edits stop the
+    // analysis, reach the playback and re-plot once the user stops typing
+    void signalEdited(int changes);
+    // Hand the edited parameters of signalIndex to the playback, if that signal is playing
+    void updatePlayback(int signalIndex);
 
 private slots:
   // --- Signal
@@ -56,6 +71,7 @@ private slots:
   void on_signal_currentIndexChanged(int index);
   void on_signal_newBtn_clicked();
   void on_signal_removeBtn_clicked();
+  void on_importBtn_clicked();
 
   // --- Signal properties
   void on_signal_name_textChanged(const QString &arg1);
@@ -79,11 +95,68 @@ private slots:
   // --- Misc
   void on_graphBtn_clicked();
   void on_playBtn_clicked();
+  void on_loopCheck_toggled(bool checked);
+  void on_openGLCheck_toggled(bool checked);
+  void on_windowType_currentIndexChanged(int index);
+  void on_frameSize_currentIndexChanged(int index);
+  void on_spectrumMode_currentIndexChanged(int index);
+
+  // --- Filter
+  void on_filterDesign_currentIndexChanged(int index);
+  void on_filterType_currentIndexChanged(int index);
+  void on_filterLow_editingFinished();
+  void on_filterHigh_editingFinished();
+  void on_filterOrder_valueChanged(int value);
+
+  // --- Analysis
+  void onAnalysisFinished(std::shared_ptr<const AnalysisResult> result);
 
 private:
+    // Chart of one panel, kept for the lifetime of the window
+    struct ChartPanel
+    {
+        QtCharts::QChartView *view = nullptr;
+        QtCharts::QChart *chart = nullptr;
+        QtCharts::QLineSeries *series = nullptr;
+        QtCharts::QValueAxis *axisX = nullptr;
+        QtCharts::QValueAxis *axisY = nullptr;
+        std::shared_ptr<const SampleSource> values;   // Full data, x = index * xStep
+        std::shared_ptr<const MinMaxPyramid> pyramid; // Over values, needed if they are not in memory
+        double xStep = 1.0;                           // Axis units between values
+    };
+
+    void setupChartPanel(ChartPanel &panel, QWidget *widget, bool dark);
+    // Plot new data, zoomed out
+    void showChartData(ChartPanel &panel, std::shared_ptr<const SampleSource> values,
+                       std::shared_ptr<const MinMaxPyramid> pyramid = nullptr, double xStep = 1.0);
+    void showChartData(ChartPanel &panel, std::shared_ptr<const std::vector<double>> values,
+                       std::shared_ptr<const MinMaxPyramid> pyramid = nullptr, double xStep = 1.0);
+    // New values over the same range as the plotted ones, keeping the axes as they are
+    void replaceChartData(ChartPanel &panel, std::shared_ptr<const std::vector<double>> values);
+    // Analyse with the filter set in the Filter tab
+    void filterEdited();
+    // Decimate the visible range of the data to the plot width
+    void refreshChartPanel(ChartPanel &panel) const;
+
     Ui::MainWindow *ui;
+    ChartPanel signalPanel;
+    ChartPanel dftPanel;
+    ChartPanel filterPanel;
+    std::shared_ptr<const AnalysisResult> shownResult; // Result in the charts
     SineWaveGenerator* generator = nullptr;
     QAudioOutput* audio = nullptr;
+    int playingIndex = -1; // Signal the generator plays, -1 when nothing plays
+    quint64 playingGeneration = 0;   // Content generation the generator plays
+    quint64 requestedGeneration = 0; // Content generation of the last analysis request
+    quint64 plottedGeneration = 0;   // Content generation shown in the charts
+    QTimer *replotTimer = nullptr;   // Debounces re-plotting while typing
+    SignalAnalyzer* analyzer = nullptr;
+    QTimer *liveTimer = nullptr;                // Shows the newest live spectrum at display rate
+    std::unique_ptr<LiveSpectrum> liveSpectrum; // Spectrum of the last frame played, computed off
+                                                // this thread from the generator's monitor
+    double liveSampleRate = 0.0;
+    bool livePlotted = false;                   // The DFT chart shows the live spectrum, ticks
+                                                // only replace its points
 
 };
 #endif // MAINWINDOW_H
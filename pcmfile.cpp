@@ -0,0 +1,167 @@
+#include "pcmfile.h"
+
+#include <string>
+
+namespace
+{
+
+constexpr quint16 WAVE_FORMAT_PCM = 1;
+constexpr quint16 WAVE_FORMAT_IEEE_FLOAT = 3;
+constexpr quint16 WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+
+quint16 readU16(const unsigned char *p)
+{
+    return static_cast<quint16>(p[0] | p[1] << 8);
+}
+
+quint32 readU32(const unsigned char *p)
+{
+    return static_cast<quint32>(p[0]) | static_cast<quint32>(p[1]) << 8 | static_cast<quint32>(p[2]) << 16 |
+           static_cast<quint32>(p[3]) << 24;
+}
+
+} // namespace
+
+PcmFile::PcmFile(const QString &path)
+    : filePath(path), file(path)
+{
+}
+
+PcmFile::~PcmFile()
+{
+    if (mapped)
+        file.unmap(const_cast<uchar *>(mapped));
+}
+
+bool PcmFile::map(QString &error)
+{
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        error = file.errorString();
+        return false;
+    }
+    mappedSize = file.size();
+    if (mappedSize == 0)
+    {
+        error = "The file is empty";
+        return false;
+    }
+    mapped = file.map(0, mappedSize);
+    if (!mapped)
+    {
+        error = file.errorString();
+        return false;
+    }
+    // The mapping stays valid without the descriptor
+    file.close();
+    return true;
+}
+
+std::shared_ptr<PcmFile> PcmFile::openWav(const QString &path, QString &error)
+{
+    std::shared_ptr<PcmFile> pcm(new PcmFile(path));
+    if (!pcm->map(error) || !pcm->parseWav(error))
+        return nullptr;
+    return pcm;
+}
+
+std::shared_ptr<PcmFile> PcmFile::openRaw(const QString &path, SampleFormat format, int sampleRate, int channels,
+                                          QString &error)
+{
+    if (sampleRate <= 0 || channels <= 0)
+    {
+        error = "Invalid sample rate or channel count";
+        return nullptr;
+    }
+
+    std::shared_ptr<PcmFile> pcm(new PcmFile(path));
+    if (!pcm->map(error))
+        return nullptr;
+    pcm->sampleFormat = format;
+    pcm->channelCount = channels;
+    pcm->rate = sampleRate;
+    pcm->samples = pcm->mapped;
+    // A trailing partial frame is ignored
+    pcm->frames = static_cast<size_t>(pcm->mappedSize) / (sampleBytes(format) * channels);
+    return pcm;
+}
+
+bool PcmFile::parseWav(QString &error)
+{
+    const unsigned char *end = mapped + mappedSize;
+    if (mappedSize < 12 || std::string(reinterpret_cast<const char *>(mapped), 4) != "RIFF" ||
+        std::string(reinterpret_cast<const char *>(mapped) + 8, 4) != "WAVE")
+    {
+        error = "Not a RIFF/WAVE file";
+        return false;
+    }
+
+    // Chunks follow each other, padded to an even size
+    bool haveFormat = false;
+    const unsigned char *chunk = mapped + 12;
+    while (end - chunk >= 8)
+    {
+        std::string id(reinterpret_cast<const char *>(chunk), 4);
+        quint64 size = readU32(chunk + 4);
+        const unsigned char *body = chunk + 8;
+        quint64 available = static_cast<quint64>(end - body);
+
+        if (id == "fmt ")
+        {
+            if (size < 16 || available < 16)
+                break;
+            quint16 tag = readU16(body);
+            channelCount = readU16(body + 2);
+            rate = static_cast<int>(readU32(body + 4));
+            quint16 bits = readU16(body + 14);
+            // The actual format is in the first two bytes of the sub-format GUID
+            if (tag == WAVE_FORMAT_EXTENSIBLE && size >= 26 && available >= 26)
+                tag = readU16(body + 24);
+
+            if (tag == WAVE_FORMAT_PCM && bits == 16)
+                sampleFormat = SampleFormat::Int16;
+            else if (tag == WAVE_FORMAT_PCM && bits == 24)
+                sampleFormat = SampleFormat::Int24;
+            else if (tag == WAVE_FORMAT_IEEE_FLOAT && bits == 32)
+                sampleFormat = SampleFormat::Float32;
+            else
+            {
+                error = QString("Unsupported WAV encoding (format %1, %2 bits)").arg(tag).arg(bits);
+                return false;
+            }
+            if (channelCount == 0 || rate <= 0)
+            {
+                error = "Invalid channel count or sample rate";
+                return false;
+            }
+            haveFormat = true;
+        }
+        else if (id == "data")
+        {
+            if (!haveFormat)
+            {
+                error = "Sample data before the format chunk";
+                return false;
+            }
+            // Writers that never finished leave the size at 0 or 0xFFFFFFFF, the data runs to the end
+            if (size == 0 || size > available)
+                size = available;
+            samples = body;
+            frames = static_cast<size_t>(size / (sampleBytes(sampleFormat) * channelCount));
+            return true;
+        }
+
+        if (size > available)
+            break;
+        chunk = body + size + (size & 1);
+    }
+
+    error = haveFormat ? "No sample data" : "No format chunk";
+    return false;
+}
+
+void PcmFile::read(size_t begin, size_t end, double *out) const
+{
+    const size_t stride = sampleBytes(sampleFormat) * channelCount;
+    decodePcm(samples + begin * stride, sampleFormat, channelCount, end - begin, out);
+}
@@ -0,0 +1,53 @@
+#ifndef PCMFILE_H
+#define PCMFILE_H
+#include <QFile>
+#include <QString>
+
+#include <memory>
+
+#include "samplesource.h"
+
+// Recording in a WAV or headerless PCM file, memory-mapped and decoded on every read.
+// Nothing is loaded up front: the system pages in the parts of the file that are read,
+// so files of any size open at once and cost no memory of their own. Multi-channel files
+// are read as the average of their channels.
+class PcmFile : public SampleSource
+{
+public:
+    // WAV with 16 or 24-bit integer or 32-bit float samples (WAVE_FORMAT_EXTENSIBLE too).
+    // Returns nullptr and sets error if the file cannot be mapped or is not such a WAV
+    static std::shared_ptr<PcmFile> openWav(const QString &path, QString &error);
+
+    // Headerless interleaved samples
+    static std::shared_ptr<PcmFile> openRaw(const QString &path, SampleFormat format, int sampleRate,
+                                            int channels, QString &error);
+
+    ~PcmFile() override;
+
+    size_t size() const override { return frames; }
+    int sampleRate() const override { return rate; }
+    void read(size_t begin, size_t end, double *out) const override;
+
+    const QString &path() const { return filePath; }
+    SampleFormat format() const { return sampleFormat; }
+    int channels() const { return channelCount; }
+
+private:
+    PcmFile(const QString &path);
+
+    // Map the file and point at the sample data, false with error set on failure
+    bool map(QString &error);
+    bool parseWav(QString &error);
+
+    QString filePath;
+    QFile file;
+    const unsigned char *mapped = nullptr; // Whole file
+    qint64 mappedSize = 0;
+    const unsigned char *samples = nullptr; // First frame
+    size_t frames = 0;
+    SampleFormat sampleFormat = SampleFormat::Int16;
+    int channelCount = 1;
+    int rate = 0;
+};
+
+#endif // PCMFILE_H
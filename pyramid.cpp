@@ -0,0 +1,205 @@
+#include "pyramid.h"
+#include "samplesource.h"
+#include <algorithm>
+
+namespace
+{
+
+// Min/max of consecutive nodes, keeping track of which came first
+struct Extent
+{
+    float min, max;
+    bool maxFirst;
+};
+
+Extent merge(const Extent &left, const Extent &right)
+{
+    Extent merged;
+    bool minLeft = left.min <= right.min;
+    bool maxLeft = left.max >= right.max;
+    merged.min = minLeft ? left.min : right.min;
+    merged.max = maxLeft ? left.max : right.max;
+    if (minLeft == maxLeft)
+        merged.maxFirst = minLeft ? left.maxFirst : right.maxFirst;
+    else
+        merged.maxFirst = maxLeft;
+    return merged;
+}
+
+} // namespace
+
+void MinMaxPyramid::clear()
+{
+    levels.clear();
+    count = 0;
+}
+
+size_t MinMaxPyramid::memoryUsage() const
+{
+    size_t bytes = 0;
+    for (const Level &level : levels)
+        bytes += level.min.capacity() * sizeof(float) + level.max.capacity() * sizeof(float) +
+                 level.maxFirst.capacity();
+    return bytes;
+}
+
+void MinMaxPyramid::build(const double *samples, size_t length)
+{
+    clear();
+    count = length;
+    if (length == 0)
+        return;
+
+    levels.emplace_back();
+    addBase(samples, length, 0);
+    addLevels();
+}
+
+void MinMaxPyramid::build(const SampleSource &source)
+{
+    clear();
+    count = source.size();
+    if (count == 0)
+        return;
+
+    // Chunks of whole base blocks
+    constexpr size_t CHUNK = BASE_BLOCK * 4096;
+    std::vector<double> chunk(CHUNK);
+    levels.emplace_back();
+    size_t nodes = (count + BASE_BLOCK - 1) / BASE_BLOCK;
+    levels.front().min.reserve(nodes);
+    levels.front().max.reserve(nodes);
+    levels.front().maxFirst.reserve(nodes);
+    for (size_t begin = 0; begin < count; begin += CHUNK)
+    {
+        size_t end = std::min(count, begin + CHUNK);
+        source.read(begin, end, chunk.data());
+        addBase(chunk.data(), end - begin, begin / BASE_BLOCK);
+    }
+    addLevels();
+}
+
+void MinMaxPyramid::addBase(const double *samples, size_t length, size_t first)
+{
+    Level &base = levels.front();
+    size_t nodes = (length + BASE_BLOCK - 1) / BASE_BLOCK;
+    base.min.resize(first + nodes);
+    base.max.resize(first + nodes);
+    base.maxFirst.resize(first + nodes);
+    for (size_t b = 0; b < nodes; b++)
+    {
+        size_t from = b * BASE_BLOCK, to = std::min(length, from + BASE_BLOCK);
+        size_t lo = from, hi = from;
+        for (size_t i = from + 1; i < to; i++)
+        {
+            if (samples[i] < samples[lo])
+                lo = i;
+            if (samples[i] > samples[hi])
+                hi = i;
+        }
+        base.min[first + b] = static_cast<float>(samples[lo]);
+        base.max[first + b] = static_cast<float>(samples[hi]);
+        base.maxFirst[first + b] = hi < lo;
+    }
+}
+
+void MinMaxPyramid::addLevels()
+{
+    // Every further level halves the previous one
+    while (levels.back().min.size() > 1)
+    {
+        const Level &fine = levels.back();
+        Level coarse;
+        size_t fineNodes = fine.min.size();
+        size_t nodes = (fineNodes + 1) / 2;
+        coarse.min.resize(nodes);
+        coarse.max.resize(nodes);
+        coarse.maxFirst.resize(nodes);
+        for (size_t b = 0; b < nodes; b++)
+        {
+            Extent e{fine.min[2 * b], fine.max[2 * b], fine.maxFirst[2 * b] != 0};
+            if (2 * b + 1 < fineNodes)
+                e = merge(e, Extent{fine.min[2 * b + 1], fine.max[2 * b + 1], fine.maxFirst[2 * b + 1] != 0});
+            coarse.min[b] = e.min;
+            coarse.max[b] = e.max;
+            coarse.maxFirst[b] = e.maxFirst;
+        }
+        levels.push_back(std::move(coarse));
+    }
+}
+
+size_t MinMaxPyramid::levelFor(size_t length, size_t buckets) const
+{
+    // Coarsest level with blocks at most half a bucket wide
+    const double width = buckets ? static_cast<double>(length) / buckets : 0.0;
+    size_t level = levels.size();
+    for (size_t k = 0; k < levels.size() && static_cast<double>(BASE_BLOCK << k) <= width / 2; k++)
+        level = k;
+    return level;
+}
+
+void MinMaxPyramid::envelope(const double *samples, size_t begin, size_t end, size_t buckets,
+                             std::vector<PlotPoint> &out) const
+{
+    end = std::min(end, count);
+    out.clear();
+    if (end <= begin)
+        return;
+
+    size_t level = levelFor(end - begin, buckets);
+    if (level == levels.size())
+    {
+        // Zoomed in close, the samples themselves are cheap enough
+        minMaxDecimate(samples, begin, end, buckets, out);
+        return;
+    }
+
+    const Level &nodes = levels[level];
+    const size_t block = BASE_BLOCK << level;
+    const size_t first = begin / block;
+    const size_t last = std::min(nodes.min.size(), (end + block - 1) / block);
+    const size_t blocks = last - first; // At least 2 per bucket
+
+    out.reserve(2 * buckets);
+    for (size_t b = 0; b < buckets; b++)
+    {
+        size_t from = first + b * blocks / buckets;
+        size_t to = first + (b + 1) * blocks / buckets;
+
+        Extent e{nodes.min[from], nodes.max[from], nodes.maxFirst[from] != 0};
+        for (size_t i = from + 1; i < to; i++)
+            e = merge(e, Extent{nodes.min[i], nodes.max[i], nodes.maxFirst[i] != 0});
+
+        // Placed at the edges of the bucket, the order of the extremes is kept
+        double x0 = static_cast<double>(from * block);
+        double x1 = static_cast<double>(std::min(to * block, count) - 1);
+        double y0 = e.maxFirst ? e.max : e.min;
+        double y1 = e.maxFirst ? e.min : e.max;
+        out.push_back({x0, y0});
+        out.push_back({x1, y1});
+    }
+}
+
+void MinMaxPyramid::envelope(const SampleSource &source, size_t begin, size_t end, size_t buckets,
+                             std::vector<PlotPoint> &out) const
+{
+    if (const double *samples = source.data())
+    {
+        envelope(samples, begin, end, buckets, out);
+        return;
+    }
+
+    end = std::min(end, count);
+    if (end > begin && levelFor(end - begin, buckets) == levels.size())
+    {
+        // Zoomed in close: at most 8 samples per bucket are read
+        std::vector<double> samples(end - begin);
+        source.read(begin, end, samples.data());
+        minMaxDecimate(samples.data(), 0, samples.size(), buckets, out);
+        for (PlotPoint &point : out)
+            point.x += static_cast<double>(begin);
+        return;
+    }
+    // The raw samples are not touched
+    envelope(nullptr, begin, end, buckets, out);
+}
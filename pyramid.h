@@ -0,0 +1,67 @@
+#ifndef PYRAMID_H
+#define PYRAMID_H
+#include <cstddef>
+#include <vector>
+
+#include "decimate.h"
+
+class SampleSource;
+
+// Min/max mip-pyramid over a sample buffer, for zooming and panning long signals.
+// Level k keeps the minimum and maximum of every block of 4 << k samples (4, 8, 16, ...),
+// about half a node per sample in total. Values are stored as float, which is plenty for
+// plotting. Any range at any zoom is served from the level whose blocks are at most half a
+// bucket wide, so envelope() costs O(buckets) whatever the length of the range.
+class MinMaxPyramid
+{
+public:
+    MinMaxPyramid() = default;
+
+    // Build over samples[0, count), replacing what was there
+    void build(const double *samples, size_t count);
+    // Same, reading the source chunk by chunk: the samples never have to be in memory at once
+    void build(const SampleSource &source);
+    void clear();
+
+    // Smallest and largest sample, 0 for an empty pyramid
+    float minimum() const { return levels.empty() ? 0.0f : levels.back().min[0]; }
+    float maximum() const { return levels.empty() ? 0.0f : levels.back().max[0]; }
+
+    // Number of samples the pyramid was built over
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    // Bytes held by the levels
+    size_t memoryUsage() const;
+
+    // Same envelope as minMaxDecimate(samples, begin, end, buckets), samples being the buffer
+    // the pyramid was built over. Bucket edges are snapped to the blocks of the level used, which
+    // moves them by less than half a bucket; no sample of the range is missed. The raw samples
+    // are only read when buckets are narrower than 8 samples, O(8 * buckets) at most.
+    void envelope(const double *samples, size_t begin, size_t end, size_t buckets,
+                  std::vector<PlotPoint> &out) const;
+    // Same over a source, only the few raw samples of a close zoom are read from it
+    void envelope(const SampleSource &source, size_t begin, size_t end, size_t buckets,
+                  std::vector<PlotPoint> &out) const;
+
+private:
+    struct Level
+    {
+        std::vector<float> min, max;
+        std::vector<unsigned char> maxFirst; // The maximum occurs before the minimum
+    };
+
+    static constexpr size_t BASE_BLOCK = 4;
+
+    // Base nodes of samples[0, length), which start at node first
+    void addBase(const double *samples, size_t length, size_t first);
+    // Every level above the base
+    void addLevels();
+    // Level used for buckets over length samples, levels.size() when the raw samples are needed
+    size_t levelFor(size_t length, size_t buckets) const;
+
+    std::vector<Level> levels;
+    size_t count = 0;
+};
+
+#endif // PYRAMID_H
@@ -0,0 +1,127 @@
+#include "resampler.h"
+#include "sharedcache.h"
+#include "window.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace
+{
+
+// Taps per phase when interpolating, enough for about 80 dB of stop band with the Kaiser taper
+constexpr size_t BASE_TAPS = 32;
+constexpr size_t MAX_TAPS = 512;
+
+// Input samples process() appends to its buffer at a time, reserved up front
+constexpr size_t CHUNK = 1024;
+
+// Rate pairs in use at once: the device rate against the few rates of the loaded signals
+SharedCache<std::pair<int, int>, PolyphaseBank> cache(16);
+
+} // namespace
+
+std::shared_ptr<const PolyphaseBank> PolyphaseBank::get(int inputRate, int outputRate)
+{
+    return cache.get({inputRate, outputRate},
+                     [=] { return std::make_shared<const PolyphaseBank>(inputRate, outputRate); });
+}
+
+void PolyphaseBank::clearCache()
+{
+    cache.clear();
+}
+
+PolyphaseBank::PolyphaseBank(int inputRate, int outputRate)
+{
+    inputRate = std::max(inputRate, 1);
+    outputRate = std::max(outputRate, 1);
+    int divisor = std::gcd(inputRate, outputRate);
+    upFactor = static_cast<size_t>(outputRate / divisor);
+    downFactor = static_cast<size_t>(inputRate / divisor);
+    phaseCount = std::min(upFactor, MAX_PHASES);
+
+    size_t widen = (downFactor + upFactor - 1) / upFactor;
+    tapCount = std::min(BASE_TAPS * widen, MAX_TAPS);
+
+    // Cutoff below the lower of the two Nyquist frequencies, in cycles per input sample,
+    // with room for the transition band
+    const double cutoff = 0.46 * std::min(1.0, static_cast<double>(upFactor) / downFactor);
+
+    // The periodic Kaiser table over all phases interleaved is the window at every tap position.
+    // Built once per bank, which is cached itself, so it stays out of the window cache
+    const size_t length = tapCount * phaseCount;
+    const Window window(WindowType::Kaiser, length);
+
+    // Rounded phases can reach phaseCount, the taps one whole input sample later
+    const size_t stored = phaseCount < upFactor ? phaseCount + 1 : phaseCount;
+    coefficients.resize(tapCount * stored);
+    for (size_t p = 0; p < stored; p++)
+    {
+        double *taps = coefficients.data() + p * tapCount;
+        double sum = 0.0;
+        for (size_t k = 0; k < tapCount; k++)
+        {
+            // Tap k multiplies the input j samples before the newest one
+            size_t j = tapCount - 1 - k;
+            double t = static_cast<double>(j) + static_cast<double>(p) / phaseCount - 0.5 * tapCount;
+            double x = 2.0 * cutoff * t;
+            double sinc = x == 0.0 ? 1.0 : std::sin(M_PI * x) / (M_PI * x);
+            taps[k] = 2.0 * cutoff * sinc * window[(j * phaseCount + p) % length];
+            sum += taps[k];
+        }
+        // Unity gain at DC for every phase, no ripple from the phase switching
+        for (size_t k = 0; k < tapCount; k++)
+            taps[k] /= sum;
+    }
+}
+
+Resampler::Resampler(int inputRate, int outputRate)
+    : bank(PolyphaseBank::get(inputRate, outputRate))
+{
+    buffer.reserve(bank->taps() + CHUNK);
+    reset();
+}
+
+void Resampler::reset()
+{
+    // Silence before the first sample; the first output is centred on it
+    buffer.assign(bank->taps() - 1, 0.0);
+    position = bank->taps() - 1 + latency();
+    fraction = 0;
+}
+
+size_t Resampler::process(const double *in, size_t count, double *out)
+{
+    const size_t taps = bank->taps();
+    const size_t up = bank->up();
+    const size_t down = bank->down();
+    const size_t phases = bank->phases();
+
+    size_t written = 0;
+    for (size_t begin = 0; begin < count; begin += CHUNK)
+    {
+        size_t n = std::min(CHUNK, count - begin);
+        buffer.insert(buffer.end(), in + begin, in + begin + n);
+
+        while (position < buffer.size())
+        {
+            const double *x = buffer.data() + position + 1 - taps;
+            // The nearest stored phase, rounded
+            const double *h = bank->phase(phases == up ? fraction : (2 * fraction * phases + up) / (2 * up));
+            double sum = 0.0;
+            for (size_t k = 0; k < taps; k++)
+                sum += x[k] * h[k];
+            out[written++] = sum;
+
+            fraction += down;
+            position += fraction / up;
+            fraction %= up;
+        }
+
+        // Keep the history the next outputs reach back to
+        size_t drop = std::min(buffer.size(), position - (taps - 1));
+        buffer.erase(buffer.begin(), buffer.begin() + drop);
+        position -= drop;
+    }
+    return written;
+}
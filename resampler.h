@@ -0,0 +1,72 @@
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Kaiser-windowed sinc interpolation filter for one rational rate change, split into phases.
+// The rates are reduced to up / down; output sample k sits k * down / up input samples after
+// the first one, and phase p holds the taps for a position p / phases() past an input sample.
+// Ratios with more than MAX_PHASES phases use the nearest of MAX_PHASES evenly spaced ones.
+// Shared through a cache like the FFT plans and windows.
+class PolyphaseBank
+{
+public:
+    static std::shared_ptr<const PolyphaseBank> get(int inputRate, int outputRate);
+    static void clearCache();
+
+    PolyphaseBank(int inputRate, int outputRate);
+
+    size_t up() const { return upFactor; }
+    size_t down() const { return downFactor; }
+    size_t phases() const { return phaseCount; }
+    // Taps per phase, more when decimating so that the narrower pass band keeps its steepness
+    size_t taps() const { return tapCount; }
+    // Taps of phase p, in the order of the input samples they multiply (oldest first).
+    // Banks with fewer phases than up() also hold p = phases(), a whole input sample past,
+    // for positions that round up to the next sample
+    const double *phase(size_t p) const { return coefficients.data() + p * tapCount; }
+
+private:
+    size_t upFactor, downFactor;
+    size_t phaseCount;
+    size_t tapCount;
+    std::vector<double> coefficients;
+};
+
+// Most phases a bank stores, about 1/2000 of an input sample of timing error beyond that
+constexpr size_t MAX_PHASES = 1024;
+
+// Streaming sample rate converter.
+// Output sample k is the input at time k / outputRate: the filter looks latency() input
+// samples ahead, so the end of a stream needs that many zeros pushed after it to come out.
+// process() allocates nothing, a real-time thread can use it.
+class Resampler
+{
+public:
+    Resampler(int inputRate, int outputRate);
+
+    // Back to the first input sample
+    void reset();
+
+    // Consume count input samples and write the output samples they complete, return how many.
+    // out needs room for maxOutput(count)
+    size_t process(const double *in, size_t count, double *out);
+
+    // Most output samples process() writes for count input samples
+    size_t maxOutput(size_t count) const { return count * bank->up() / bank->down() + 2; }
+    // Input samples that yield at least count output samples
+    size_t inputFor(size_t count) const { return count * bank->down() / bank->up() + 1; }
+    // Input samples the filter looks ahead
+    size_t latency() const { return bank->taps() / 2; }
+
+    double ratio() const { return static_cast<double>(bank->up()) / bank->down(); }
+
+private:
+    std::shared_ptr<const PolyphaseBank> bank;
+    std::vector<double> buffer; // taps - 1 samples of history followed by the pending input
+    size_t position = 0;        // Newest input sample of the next output, in buffer
+    size_t fraction = 0;        // Position of the next output past it, in 1/up input samples
+};
+
+#endif // RESAMPLER_H
@@ -0,0 +1,71 @@
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Single-writer, single-reader FIFO of values, wait-free on both sides.
+// The writer never waits for the reader: whatever does not fit is dropped, so a slow
+// reader loses samples instead of stalling the writer. Capacity is rounded up to a power
+// of two; nothing is allocated after construction.
+template <class T>
+class RingBuffer
+{
+public:
+    explicit RingBuffer(size_t capacity)
+    {
+        size_t size = 1;
+        while (size < capacity)
+            size *= 2;
+        slots.resize(size);
+        mask = size - 1;
+    }
+
+    size_t capacity() const { return slots.size(); }
+
+    // Writer: append up to count values, return how many fitted
+    size_t push(const T *values, size_t count)
+    {
+        size_t tail = writePos.load(std::memory_order_relaxed);
+        size_t head = readPos.load(std::memory_order_acquire);
+        count = std::min(count, slots.size() - (tail - head));
+        for (size_t i = 0; i < count; i++)
+            slots[(tail + i) & mask] = values[i];
+        writePos.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    // Reader: values ready to pop
+    size_t available() const
+    {
+        return writePos.load(std::memory_order_acquire) - readPos.load(std::memory_order_relaxed);
+    }
+
+    // Reader: take up to count of the oldest values, return how many were taken
+    size_t pop(T *values, size_t count)
+    {
+        size_t head = readPos.load(std::memory_order_relaxed);
+        size_t tail = writePos.load(std::memory_order_acquire);
+        count = std::min(count, tail - head);
+        for (size_t i = 0; i < count; i++)
+            values[i] = slots[(head + i) & mask];
+        readPos.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    // Reader: drop everything written so far
+    void discard()
+    {
+        readPos.store(writePos.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+private:
+    std::vector<T> slots;
+    size_t mask = 0;
+    // Running counts, only their difference matters (wraps around safely)
+    alignas(64) std::atomic<size_t> writePos{0};
+    alignas(64) std::atomic<size_t> readPos{0};
+};
+
+#endif // RINGBUFFER_H
@@ -0,0 +1,100 @@
+#include "samplesource.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+
+// One channel's value at p, scaled to [-1, 1)
+double decodeInt16(const unsigned char *p)
+{
+    return static_cast<int16_t>(p[0] | (p[1] << 8)) * (1.0 / 32768.0);
+}
+
+double decodeInt24(const unsigned char *p)
+{
+    // Sign extended from bit 23
+    int32_t value = static_cast<int32_t>(static_cast<uint32_t>(p[0]) << 8 | static_cast<uint32_t>(p[1]) << 16 |
+                                         static_cast<uint32_t>(p[2]) << 24) >> 8;
+    return value * (1.0 / 8388608.0);
+}
+
+double decodeFloat32(const unsigned char *p)
+{
+    // Little-endian hosts only, like the rest of the PCM handling
+    float value;
+    std::memcpy(&value, p, sizeof value);
+    return value;
+}
+
+// One loop per format so the decoder inlines
+template <double (*decode)(const unsigned char *)>
+void decodeFrames(const unsigned char *frames, size_t bytes, int channels, size_t count, double *out)
+{
+    const size_t stride = bytes * channels;
+    if (channels == 1)
+    {
+        for (size_t i = 0; i < count; i++)
+            out[i] = decode(frames + i * bytes);
+        return;
+    }
+
+    const double scale = 1.0 / channels;
+    for (size_t i = 0; i < count; i++)
+    {
+        const unsigned char *frame = frames + i * stride;
+        double sum = 0.0;
+        for (int c = 0; c < channels; c++)
+            sum += decode(frame + c * bytes);
+        out[i] = sum * scale;
+    }
+}
+
+} // namespace
+
+void BufferSource::read(size_t begin, size_t end, double *out) const
+{
+    std::copy(samples->begin() + begin, samples->begin() + end, out);
+}
+
+size_t sampleBytes(SampleFormat format)
+{
+    switch (format)
+    {
+    case SampleFormat::Int16:
+        return 2;
+    case SampleFormat::Int24:
+        return 3;
+    case SampleFormat::Float32:
+        return 4;
+    }
+    return 0;
+}
+
+void decodePcm(const unsigned char *frames, SampleFormat format, int channels, size_t count, double *out)
+{
+    const size_t bytes = sampleBytes(format);
+    switch (format)
+    {
+    case SampleFormat::Int16:
+        decodeFrames<decodeInt16>(frames, bytes, channels, count, out);
+        break;
+    case SampleFormat::Int24:
+        decodeFrames<decodeInt24>(frames, bytes, channels, count, out);
+        break;
+    case SampleFormat::Float32:
+        decodeFrames<decodeFloat32>(frames, bytes, channels, count, out);
+        break;
+    }
+}
+
+void encodePcm16(const double *samples, size_t count, unsigned char *out)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        int16_t sample = static_cast<int16_t>(32767.0 * std::clamp(samples[i], -1.0, 1.0));
+        out[2 * i] = static_cast<unsigned char>(sample & 0xFF);
+        out[2 * i + 1] = static_cast<unsigned char>((sample >> 8) & 0xFF);
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef SAMPLESOURCE_H
+#define SAMPLESOURCE_H
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Random access to a mono stream of samples, read in chunks.
+// Lets analysis and plotting work on data that is not held as doubles in memory,
+// e.g. a recording decoded from a memory-mapped file as it is read.
+class SampleSource
+{
+public:
+    virtual ~SampleSource() = default;
+
+    virtual size_t size() const = 0;
+    // Samples per second, 0 if the values are not a time series (e.g. a spectrum)
+    virtual int sampleRate() const = 0;
+
+    // Write samples [begin, end) into out, end <= size(). Safe to call from several threads
+    virtual void read(size_t begin, size_t end, double *out) const = 0;
+
+    // The samples as doubles in memory, nullptr if they are decoded on every read
+    virtual const double *data() const { return nullptr; }
+
+    // Bytes held in memory (mapped file pages are the system's, not counted)
+    virtual size_t memoryUsage() const { return 0; }
+};
+
+// Samples already in memory
+class BufferSource : public SampleSource
+{
+public:
+    BufferSource(std::shared_ptr<const std::vector<double>> samples, int sampleRate)
+        : samples(std::move(samples)), rate(sampleRate) {}
+
+    size_t size() const override { return samples->size(); }
+    int sampleRate() const override { return rate; }
+    void read(size_t begin, size_t end, double *out) const override;
+    const double *data() const override { return samples->data(); }
+    size_t memoryUsage() const override { return samples->capacity() * sizeof(double); }
+
+private:
+    std::shared_ptr<const std::vector<double>> samples;
+    int rate;
+};
+
+// Encodings of PCM sample data, little-endian
+enum class SampleFormat
+{
+    Int16,
+    Int24,
+    Float32
+};
+
+// Bytes per sample of one channel
+size_t sampleBytes(SampleFormat format);
+
+// Decode count frames of interleaved channels starting at frames, averaging the channels to mono.
+// Integers are scaled to [-1, 1), floats are taken as they are
+void decodePcm(const unsigned char *frames, SampleFormat format, int channels, size_t count, double *out);
+
+// Encode count samples as 16-bit little-endian PCM (2 * count bytes), clipped to [-1, 1]
+void encodePcm16(const double *samples, size_t count, unsigned char *out);
+
+#endif // SAMPLESOURCE_H
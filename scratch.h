@@ -0,0 +1,49 @@
+#ifndef SCRATCH_H
+#define SCRATCH_H
+#include <cstddef>
+#include <vector>
+
+// Work buffer borrowed from a per-thread free list for the lifetime of the object.
+//
+// A thread waiting in ThreadPool::parallelFor runs other queued tasks meanwhile, and those
+// may start another transform on the same thread. A single thread_local buffer would then
+// be resized under the waiting caller; each ScratchBuffer instead owns its buffer until it
+// goes out of scope, and nested users take another one from the list. Buffers only grow
+// and go back to the list, so repeated work on a thread does not allocate.
+template <class T>
+class ScratchBuffer
+{
+public:
+    explicit ScratchBuffer(size_t n)
+    {
+        std::vector<std::vector<T>> &list = freeList();
+        if (!list.empty())
+        {
+            buffer.swap(list.back());
+            list.pop_back();
+        }
+        if (buffer.size() < n)
+            buffer.resize(n);
+    }
+
+    ~ScratchBuffer()
+    {
+        freeList().push_back(std::move(buffer));
+    }
+
+    ScratchBuffer(const ScratchBuffer &) = delete;
+    ScratchBuffer &operator=(const ScratchBuffer &) = delete;
+
+    T *data() { return buffer.data(); }
+
+private:
+    static std::vector<std::vector<T>> &freeList()
+    {
+        thread_local std::vector<std::vector<T>> list;
+        return list;
+    }
+
+    std::vector<T> buffer;
+};
+
+#endif // SCRATCH_H
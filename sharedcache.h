@@ -0,0 +1,82 @@
+#ifndef SHAREDCACHE_H
+#define SHAREDCACHE_H
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+
+// Process-wide cache of immutable objects built from a key (FFT plans, windows, filter banks).
+// Holds at most `capacity` entries and drops the least recently used one beyond that;
+// callers still holding a dropped object keep it alive through their shared_ptr.
+// Safe to call from any thread.
+template <class Key, class Value>
+class SharedCache
+{
+public:
+    explicit SharedCache(size_t capacity) : capacity(capacity) {}
+
+    // Cached object for key, or build() (returning a shared_ptr<const Value>) stored and returned.
+    // build runs outside the lock so that it may use this or other caches itself; two threads
+    // may then build the same object and the first one stored wins.
+    template <class Build>
+    std::shared_ptr<const Value> get(const Key &key, Build build)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = entries.find(key);
+            if (it != entries.end())
+            {
+                it->second.lastUse = ++clock;
+                return it->second.value;
+            }
+        }
+
+        std::shared_ptr<const Value> value = build();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto inserted = entries.emplace(key, Entry{std::move(value), 0});
+        inserted.first->second.lastUse = ++clock;
+        if (inserted.second && entries.size() > capacity)
+            evictOldest();
+        return inserted.first->second.value;
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+    }
+
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.size();
+    }
+
+private:
+    struct Entry
+    {
+        std::shared_ptr<const Value> value;
+        uint64_t lastUse;
+    };
+
+    // A linear scan, the caches hold a few dozen entries
+    void evictOldest()
+    {
+        auto oldest = entries.begin();
+        for (auto it = entries.begin(); it != entries.end(); ++it)
+        {
+            if (it->second.lastUse < oldest->second.lastUse)
+                oldest = it;
+        }
+        entries.erase(oldest);
+    }
+
+    const size_t capacity;
+    mutable std::mutex mutex;
+    std::map<Key, Entry> entries;
+    uint64_t clock = 0;
+};
+
+#endif // SHAREDCACHE_H
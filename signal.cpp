@@ -1,50 +1,160 @@
 #include "signal.h"
+#include "spectrum.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <iostream>
 
+namespace
+{
+
+// Shared by all signals, so a generation never repeats, even across copies
+std::atomic<quint64> lastGeneration{0};
+
+} // namespace
+
+void Signal::changed(int changes)
+{
+    quint64 generation = ++lastGeneration;
+    if (changes & NameChange)
+        nameGeneration = generation;
+    if (changes & SynthesisChange)
+    {
+        synthesisGeneration = generation;
+        bankDirty = true;
+    }
+    if (changes & SamplingChange)
+        samplingGeneration = generation;
+}
+
+quint64 Signal::getGeneration(int changes) const
+{
+    quint64 generation = 0;
+    if (changes & NameChange)
+        generation = std::max(generation, nameGeneration);
+    if (changes & SynthesisChange)
+        generation = std::max(generation, synthesisGeneration);
+    if (changes & SamplingChange)
+        generation = std::max(generation, samplingGeneration);
+    return generation;
+}
+
 // Calculate samples for the entire signal (duration*sampleRate)
 std::vector<double> Signal::getSamples() const
 {
-    std::vector<double> samples;
+    std::vector<double> samples(getSampleCount());
+    getSamples(0, samples.size(), samples.data());
+    return samples;
+}
+
+size_t Signal::getSampleCount() const
+{
+    if (source)
+        return source->size();
     int points = sampleRate * duration;
-    samples.reserve(points);
+    return points > 0 ? points : 0;
+}
 
-    // Sample the signal at each point in time
-    for (int n = 0; n < points; n++)
+void Signal::getSamples(size_t begin, size_t end, double *out) const
+{
+    if (source)
     {
-        double value = getValue(static_cast<double>(n) / sampleRate);
-        samples.push_back(value);
+        source->read(begin, end, out);
+        return;
     }
 
-    return samples;
+    // Same values as getValue at each point in time, synthesized with
+    // incremental oscillators instead of a std::cos per overtone per sample
+    synthesize(getBank(), sampleRate, begin, end, out);
 }
 
 
-std::vector<std::complex<double>> Signal::getDFT() const
+std::vector<std::complex<double>> Signal::getDFT(WindowType window) const
+{
+    // The samples are real, so the upper half is the mirrored conjugate of the lower one
+    return mirrorSpectrum(getRealDFT(window), sampleRate > 0 ? sampleRate : 0);
+}
+
+std::vector<std::complex<double>> Signal::getRealDFT(WindowType window) const
 {
-    
     // Calculate samples for the entire signal
-    std::vector<double> samples = getSamples();
-    if (samples.empty())
+    return getRealDFT(getSamples(), window);
+}
+
+size_t Signal::getDFTWindowLength() const
+{
+    return sampleRate > 0 ? std::min(getSampleCount(), static_cast<size_t>(sampleRate)) : 0;
+}
+
+std::vector<std::complex<double>> Signal::getRealDFT(std::vector<double> samples, WindowType window) const
+{
+    if (samples.empty() || sampleRate <= 0)
     {
         std::cerr << "No samples available for DFT calculation." << std::endl;
         return {};
     }
-    
-    // Calculate the Discrete Fourier Transform (DFT)
-    std::vector<std::complex<double>> DFT;
-    DFT.resize(sampleRate);
-    
-    // https://en.wikipedia.org/wiki/Discrete_Fourier_transform#Example_2
-    for (size_t k = 0; k < sampleRate; k++)
+
+    // The DFT is taken over the first sampleRate samples,
+    // signals shorter than a second are zero-padded
+    return realDFT(std::move(samples), static_cast<size_t>(sampleRate), window);
+}
+
+namespace
+{
+
+// FNV-1a over the bytes of a value
+void hashBytes(quint64 &hash, const void *data, size_t size)
+{
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; i++)
     {
-        std::complex<double> sum = 0.0;
-        for (size_t n = 0; n < sampleRate; n++)
-        {
-            double angle = -2.0 * M_PI * k * n / sampleRate;
-            std::complex<double> expTerm = std::exp(std::complex<double>(0, angle));
-            sum += samples[n] * expTerm;
-        }
-        DFT[k] = sum;
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
     }
-    return DFT;
-}
\ No newline at end of file
+}
+
+void hashDouble(quint64 &hash, double value)
+{
+    // -0.0 and 0.0 give the same samples
+    if (value == 0.0)
+        value = 0.0;
+    hashBytes(hash, &value, sizeof(value));
+}
+
+} // namespace
+
+quint64 Signal::contentHash() const
+{
+    quint64 generation = getGeneration(ContentChange);
+    if (hashGeneration == generation)
+        return hash;
+
+    hash = 14695981039346656037ull;
+    hashBytes(hash, &sampleRate, sizeof(sampleRate));
+    hashDouble(hash, duration);
+    // A source is immutable, the object stands for its samples
+    const SampleSource *recording = source.get();
+    hashBytes(hash, &recording, sizeof(recording));
+    for (const auto &ot : overtones)
+    {
+        hashDouble(hash, ot.amplitude);
+        hashDouble(hash, ot.frequency);
+        hashDouble(hash, ot.phase);
+    }
+    hashGeneration = generation;
+    return hash;
+}
+
+bool Signal::sameContent(const Signal &other) const
+{
+    if (sampleRate != other.sampleRate || duration != other.duration || source != other.source ||
+        overtones.size() != other.overtones.size())
+        return false;
+    for (size_t i = 0; i < overtones.size(); i++)
+    {
+        const overtone &a = overtones[i], &b = other.overtones[i];
+        if (a.amplitude != b.amplitude || a.frequency != b.frequency || a.phase != b.phase)
+            return false;
+    }
+    return true;
+}
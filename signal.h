@@ -8,6 +8,12 @@
 
 #include <QIODevice>
 
+#include "synth.h"
+#include "window.h"
+#include "samplesource.h"
+
+#include <memory>
+
 // Overtone structure representing a harmonic signal
 // https://ru.wikipedia.org/wiki/%D0%93%D0%B0%D1%80%D0%BC%D0%BE%D0%BD%D0%B8%D1%87%D0%B5%D1%81%D0%BA%D0%B8%D0%B9_%D1%81%D0%B8%D0%B3%D0%BD%D0%B0%D0%BB
 struct overtone
@@ -40,7 +46,10 @@ struct overtone
 struct Signal
 {
     Signal(QString name, int sampleRate, double duration, const std::vector<overtone> &overtones)
-        : name(name), duration(duration), sampleRate(sampleRate), overtones(overtones) {};
+        : name(name), duration(duration), sampleRate(sampleRate), overtones(overtones)
+    {
+        changed(AnyChange);
+    }
     Signal(const QVariant &other)
     {
         QVariantMap obj = other.toMap();
@@ -50,33 +59,100 @@ struct Signal
         QVariantList arr = obj["overtones"].toList();
         for (const QVariant &val : arr)
             overtones.emplace_back(val);
+        changed(AnyChange);
     }
     ~Signal() = default;
 
     // Return samples of the signal by sampleRate and duration
     std::vector<double> getSamples() const;
 
+    // Number of samples over the duration
+    size_t getSampleCount() const;
+
+    // Write samples [begin, end) into out, so long signals can be sampled in chunks
+    void getSamples(size_t begin, size_t end, double *out) const;
+
     // Calculate the Discrete Fourier Transform (DFT) coefficients
     // by sampling the signal over its duration
-    std::vector<std::complex<double>> getDFT() const;
+    std::vector<std::complex<double>> getDFT(WindowType window = WindowType::Rectangular) const;
+
+    // Non-redundant half of getDFT (bins 0..N/2) computed with a real-input FFT,
+    // the upper bins of a real signal are the complex conjugates of these
+    std::vector<std::complex<double>> getRealDFT(WindowType window = WindowType::Rectangular) const;
+
+    // getRealDFT of samples already taken from this signal
+    std::vector<std::complex<double>> getRealDFT(std::vector<double> samples,
+                                                 WindowType window = WindowType::Rectangular) const;
+
+    // Samples the DFT window covers: the first second, or the whole signal if it is shorter
+    size_t getDFTWindowLength() const;
 
     // List of overtones making up the signal
+    // Call changed() after editing them
     std::vector<overtone> overtones;
 
+    // Recorded samples played and analysed instead of the overtones, if set.
+    // The sample count is the source's then, duration only describes it
+    std::shared_ptr<const SampleSource> source;
+
+    // What an edit touched, so that consumers can tell what is stale
+    enum Change
+    {
+        NameChange = 1,      // Signal or overtone names: nothing to recompute
+        SynthesisChange = 2, // Overtones added, removed, or their amplitude, frequency or phase
+        SamplingChange = 4,  // sampleRate or duration
+        ContentChange = SynthesisChange | SamplingChange, // Samples and spectrum are stale
+        AnyChange = NameChange | ContentChange
+    };
+
+    // Record an edit made to the public fields.
+    // Every call gets a new generation number, larger than any given out before
+    void changed(int changes);
+
+    // Generation of the last edit touching any of changes, 0 if there was none.
+    // A consumer keeps the generation it last saw and is stale once this is larger
+    quint64 getGeneration(int changes = AnyChange) const;
+
+    // Compact view of the overtone parameters, rebuilt on first use after a SynthesisChange
+    const OvertoneBank &getBank() const
+    {
+        if (bankDirty)
+        {
+            bank.clear();
+            for (const auto &ot : overtones)
+                bank.add(ot.amplitude, ot.frequency, ot.phase);
+            bankDirty = false;
+        }
+        return bank;
+    }
+
     double duration; // Duration in seconds
     int sampleRate;  // Sample rate in Hz
     QString name;    // Name of the signal
 
+    // Hash of what the samples depend on: sampleRate, duration and the overtone parameters, or the source
+    // (names are left out, renaming does not change the samples). Recomputed only after a ContentChange
+    quint64 contentHash() const;
+
+    // Same samples as other, the exact check behind contentHash
+    bool sameContent(const Signal &other) const;
+
     // Calculate the value of the signal at a given time
     const double getValue(double time) const
     {
-        double value = 0.0;
-        for (const auto &ot : overtones)
-        {
-            value += ot.getValue(time);
-        }
-        return value;
+        return getBank().value(time);
     }
+
+private:
+    quint64 nameGeneration = 0;
+    quint64 synthesisGeneration = 0;
+    quint64 samplingGeneration = 0;
+
+    mutable quint64 hash = 0;
+    mutable quint64 hashGeneration = 0;
+
+    mutable OvertoneBank bank;
+    mutable bool bankDirty = true;
 };
 
 #endif // SIGNAL_H
\ No newline at end of file
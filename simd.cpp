@@ -0,0 +1,86 @@
+#include "simd.h"
+#include "simd_impl.h"
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+
+#ifdef ELKAVOLK_SIMD_X86
+// Defined in simd_sse2.cpp, simd_avx2.cpp and simd_avx512.cpp, only callable on CPUs with that ISA
+const SimdKernels &sse2Kernels();
+const SimdKernels &avx2Kernels();
+const SimdKernels &avx512Kernels();
+#endif
+
+namespace
+{
+
+#ifdef ELKAVOLK_SIMD_X86
+// Table getters by instruction set, best first. The getters are compiled with their ISA's
+// flags (their static initializers already use its instructions), so one is only called
+// once the CPU is known to support it
+struct Candidate
+{
+    const char *name;
+    const SimdKernels &(*kernels)();
+};
+
+const Candidate CANDIDATES[] = {{"avx512", avx512Kernels}, {"avx2", avx2Kernels}, {"sse2", sse2Kernels}};
+
+bool supported(const char *name)
+{
+    __builtin_cpu_init();
+    if (std::strcmp(name, "avx512") == 0)
+        return __builtin_cpu_supports("avx512f");
+    if (std::strcmp(name, "avx2") == 0)
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    if (std::strcmp(name, "sse2") == 0)
+        return __builtin_cpu_supports("sse2");
+    return false;
+}
+#endif
+
+const SimdKernels &detect()
+{
+    const char *forced = std::getenv("ELKAVOLK_SIMD");
+    if (forced && std::strcmp(forced, "scalar") == 0)
+        return scalarKernels();
+
+#ifdef ELKAVOLK_SIMD_X86
+    if (forced)
+    {
+        for (const Candidate &candidate : CANDIDATES)
+            if (std::strcmp(forced, candidate.name) == 0 && supported(candidate.name))
+                return candidate.kernels();
+    }
+    for (const Candidate &candidate : CANDIDATES)
+        if (supported(candidate.name))
+            return candidate.kernels();
+#endif
+    return scalarKernels();
+}
+
+} // namespace
+
+const SimdKernels &scalarKernels()
+{
+    static const SimdKernels kernels = SimdImpl<ScalarVec>::table("scalar");
+    return kernels;
+}
+
+const SimdKernels &simdKernels()
+{
+    static const SimdKernels &kernels = detect();
+    return kernels;
+}
+
+std::vector<const SimdKernels *> supportedKernels()
+{
+    std::vector<const SimdKernels *> tables{&scalarKernels()};
+#ifdef ELKAVOLK_SIMD_X86
+    // Narrowest first
+    for (size_t i = std::size(CANDIDATES); i-- > 0;)
+        if (supported(CANDIDATES[i].name))
+            tables.push_back(&CANDIDATES[i].kernels());
+#endif
+    return tables;
+}
@@ -0,0 +1,51 @@
+#ifndef SIMD_H
+#define SIMD_H
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+// Vectorized kernels for the FFT butterflies, the spectrum magnitudes, Bluestein's pointwise
+// product and the Welch power sums. Complex data is in split layout: real parts in one array,
+// imaginary parts in another, so every lane of a vector register holds an independent value;
+// the *Interleaved kernels take std::complex arrays and split them in registers.
+//
+// The scalar table is the portable reference implementation; on x86 the SSE2, AVX2 (+FMA)
+// and AVX-512 tables are compiled with per-file target flags and picked at runtime by CPUID.
+// Set ELKAVOLK_SIMD=scalar|sse2|avx2|avx512 in the environment to force a table
+// (an unsupported choice falls back to the automatic detection).
+struct SimdKernels
+{
+    const char *name;
+
+    // Radix-2 decimation-in-time stage over n values combining transforms of length prev:
+    // x1 *= tw[j], (x0, x1) = (x0 + x1, x0 - x1), tw holds prev twiddles
+    void (*radix2Stage)(double *re, double *im, size_t n, size_t prev,
+                        const double *twRe, const double *twIm);
+
+    // Radix-4 decimation-in-time stage, tw holds 3*prev twiddles (q-major: w^(j*q) at (q-1)*prev + j),
+    // sign is -1 for the forward transform and +1 for the inverse one
+    void (*radix4Stage)(double *re, double *im, size_t n, size_t prev,
+                        const double *twRe, const double *twIm, double sign);
+
+    // out[k] = |x[k]|
+    void (*magnitude)(const double *re, const double *im, double *out, size_t n);
+
+    // Interleaved std::complex data, deinterleaved in registers:
+    // out[k] = |x[k]|
+    void (*magnitudeInterleaved)(const std::complex<double> *in, double *out, size_t n);
+    // a[k] *= b[k] (the pointwise product of Bluestein's convolution)
+    void (*complexMultiplyInterleaved)(std::complex<double> *a, const std::complex<double> *b, size_t n);
+    // sum[k] += |x[k]|^2 (the periodogram average of Welch's method)
+    void (*accumulatePowerInterleaved)(const std::complex<double> *in, double *sum, size_t n);
+};
+
+// Best kernels for the running CPU, detected once
+const SimdKernels &simdKernels();
+
+// Portable reference kernels
+const SimdKernels &scalarKernels();
+
+// Every table the running CPU can execute, scalar first (for comparing them in tests)
+std::vector<const SimdKernels *> supportedKernels();
+
+#endif // SIMD_H
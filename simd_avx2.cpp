@@ -0,0 +1,44 @@
+// Compiled with -mavx2 -mfma, see CMakeLists.txt
+#include <immintrin.h>
+#include "simd_impl.h"
+
+namespace
+{
+
+struct Avx2Vec
+{
+    using type = __m256d;
+    static constexpr size_t width = 4;
+
+    static type load(const double *p) { return _mm256_loadu_pd(p); }
+    static void store(double *p, type v) { _mm256_storeu_pd(p, v); }
+    static type set1(double v) { return _mm256_set1_pd(v); }
+    static type add(type a, type b) { return _mm256_add_pd(a, b); }
+    static type sub(type a, type b) { return _mm256_sub_pd(a, b); }
+    static type mul(type a, type b) { return _mm256_mul_pd(a, b); }
+    static type fmadd(type a, type b, type c) { return _mm256_fmadd_pd(a, b, c); }
+    static type fmsub(type a, type b, type c) { return _mm256_fmsub_pd(a, b, c); }
+    static type sqrt(type a) { return _mm256_sqrt_pd(a); }
+    static void deinterleave(const double *p, type &re, type &im)
+    {
+        // unpack works inside 128-bit lanes: [r0 r2 r1 r3], then restore the order
+        type a = _mm256_loadu_pd(p), b = _mm256_loadu_pd(p + 4);
+        re = _mm256_permute4x64_pd(_mm256_unpacklo_pd(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+        im = _mm256_permute4x64_pd(_mm256_unpackhi_pd(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+    }
+    static void interleave(double *p, type re, type im)
+    {
+        // [r0 i0 r2 i2] and [r1 i1 r3 i3], then the 128-bit halves in order
+        type lo = _mm256_unpacklo_pd(re, im), hi = _mm256_unpackhi_pd(re, im);
+        _mm256_storeu_pd(p, _mm256_permute2f128_pd(lo, hi, 0x20));
+        _mm256_storeu_pd(p + 4, _mm256_permute2f128_pd(lo, hi, 0x31));
+    }
+};
+
+} // namespace
+
+const SimdKernels &avx2Kernels()
+{
+    static const SimdKernels kernels = SimdImpl<Avx2Vec>::table("avx2");
+    return kernels;
+}
@@ -0,0 +1,47 @@
+// Compiled with -mavx512f, see CMakeLists.txt
+#include <immintrin.h>
+#include "simd_impl.h"
+
+namespace
+{
+
+struct Avx512Vec
+{
+    using type = __m512d;
+    static constexpr size_t width = 8;
+
+    static type load(const double *p) { return _mm512_loadu_pd(p); }
+    static void store(double *p, type v) { _mm512_storeu_pd(p, v); }
+    static type set1(double v) { return _mm512_set1_pd(v); }
+    static type add(type a, type b) { return _mm512_add_pd(a, b); }
+    static type sub(type a, type b) { return _mm512_sub_pd(a, b); }
+    static type mul(type a, type b) { return _mm512_mul_pd(a, b); }
+    static type fmadd(type a, type b, type c) { return _mm512_fmadd_pd(a, b, c); }
+    static type fmsub(type a, type b, type c) { return _mm512_fmsub_pd(a, b, c); }
+    // All lanes through the zero-masked form: _mm512_sqrt_pd passes an undefined vector as the
+    // unused merge source, which GCC's header makes a -Wmaybe-uninitialized warning
+    static type sqrt(type a) { return _mm512_maskz_sqrt_pd(0xFF, a); }
+    static void deinterleave(const double *p, type &re, type &im)
+    {
+        const __m512i even = _mm512_set_epi64(14, 12, 10, 8, 6, 4, 2, 0);
+        const __m512i odd = _mm512_set_epi64(15, 13, 11, 9, 7, 5, 3, 1);
+        type a = _mm512_loadu_pd(p), b = _mm512_loadu_pd(p + 8);
+        re = _mm512_permutex2var_pd(a, even, b);
+        im = _mm512_permutex2var_pd(a, odd, b);
+    }
+    static void interleave(double *p, type re, type im)
+    {
+        const __m512i low = _mm512_set_epi64(11, 3, 10, 2, 9, 1, 8, 0);
+        const __m512i high = _mm512_set_epi64(15, 7, 14, 6, 13, 5, 12, 4);
+        _mm512_storeu_pd(p, _mm512_permutex2var_pd(re, low, im));
+        _mm512_storeu_pd(p + 8, _mm512_permutex2var_pd(re, high, im));
+    }
+};
+
+} // namespace
+
+const SimdKernels &avx512Kernels()
+{
+    static const SimdKernels kernels = SimdImpl<Avx512Vec>::table("avx512");
+    return kernels;
+}
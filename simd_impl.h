@@ -0,0 +1,198 @@
+#ifndef SIMD_IMPL_H
+#define SIMD_IMPL_H
+#include <cmath>
+#include "simd.h"
+
+// Kernel bodies shared by every instruction set.
+// Each simd_*.cpp defines a vector type V (load, store, arithmetic, fused multiply-add, deinterleave
+// and interleave)
+// and instantiates SimdImpl<V>; lanes that do not fill a whole vector go through ScalarVec.
+// Everything lives in an anonymous namespace so each translation unit keeps its own copy
+// compiled with its own target flags.
+
+namespace
+{
+
+// One double per "vector", the portable reference
+struct ScalarVec
+{
+    using type = double;
+    static constexpr size_t width = 1;
+
+    static type load(const double *p) { return *p; }
+    static void store(double *p, type v) { *p = v; }
+    static type set1(double v) { return v; }
+    static type add(type a, type b) { return a + b; }
+    static type sub(type a, type b) { return a - b; }
+    static type mul(type a, type b) { return a * b; }
+    static type fmadd(type a, type b, type c) { return a * b + c; }
+    static type fmsub(type a, type b, type c) { return a * b - c; }
+    static type sqrt(type a) { return std::sqrt(a); }
+    static void deinterleave(const double *p, type &re, type &im)
+    {
+        re = p[0];
+        im = p[1];
+    }
+    static void interleave(double *p, type re, type im)
+    {
+        p[0] = re;
+        p[1] = im;
+    }
+};
+
+template <class V>
+struct SimdImpl
+{
+    using T = typename V::type;
+
+    // (aRe + i*aIm) * (bRe + i*bIm)
+    static void cmul(T aRe, T aIm, T bRe, T bIm, T &re, T &im)
+    {
+        re = V::fmsub(aRe, bRe, V::mul(aIm, bIm));
+        im = V::fmadd(aRe, bIm, V::mul(aIm, bRe));
+    }
+
+    template <class W>
+    static void radix2(double *re, double *im, size_t j, size_t prev, const double *twRe, const double *twIm)
+    {
+        using U = typename W::type;
+        U x0r = W::load(re + j), x0i = W::load(im + j);
+        U x1r, x1i;
+        SimdImpl<W>::cmul(W::load(re + j + prev), W::load(im + j + prev),
+                          W::load(twRe + j), W::load(twIm + j), x1r, x1i);
+        W::store(re + j, W::add(x0r, x1r));
+        W::store(im + j, W::add(x0i, x1i));
+        W::store(re + j + prev, W::sub(x0r, x1r));
+        W::store(im + j + prev, W::sub(x0i, x1i));
+    }
+
+    template <class W>
+    static void radix4(double *re, double *im, size_t j, size_t prev,
+                       const double *twRe, const double *twIm, double sign)
+    {
+        using U = typename W::type;
+        U xr[4], xi[4];
+        xr[0] = W::load(re + j);
+        xi[0] = W::load(im + j);
+        for (size_t q = 1; q < 4; q++)
+            SimdImpl<W>::cmul(W::load(re + j + q * prev), W::load(im + j + q * prev),
+                              W::load(twRe + (q - 1) * prev + j), W::load(twIm + (q - 1) * prev + j),
+                              xr[q], xi[q]);
+
+        U t0r = W::add(xr[0], xr[2]), t0i = W::add(xi[0], xi[2]);
+        U t1r = W::sub(xr[0], xr[2]), t1i = W::sub(xi[0], xi[2]);
+        U t2r = W::add(xr[1], xr[3]), t2i = W::add(xi[1], xi[3]);
+        U t3r = W::sub(xr[1], xr[3]), t3i = W::sub(xi[1], xi[3]);
+
+        // rot = t3 * i*sign
+        U s = W::set1(sign);
+        U rotr = W::mul(W::sub(W::set1(0.0), s), t3i);
+        U roti = W::mul(s, t3r);
+
+        W::store(re + j, W::add(t0r, t2r));
+        W::store(im + j, W::add(t0i, t2i));
+        W::store(re + j + prev, W::add(t1r, rotr));
+        W::store(im + j + prev, W::add(t1i, roti));
+        W::store(re + j + 2 * prev, W::sub(t0r, t2r));
+        W::store(im + j + 2 * prev, W::sub(t0i, t2i));
+        W::store(re + j + 3 * prev, W::sub(t1r, rotr));
+        W::store(im + j + 3 * prev, W::sub(t1i, roti));
+    }
+
+    static void radix2Stage(double *re, double *im, size_t n, size_t prev,
+                            const double *twRe, const double *twIm)
+    {
+        for (size_t b = 0; b < n; b += 2 * prev)
+        {
+            size_t j = 0;
+            for (; j + V::width <= prev; j += V::width)
+                radix2<V>(re + b, im + b, j, prev, twRe, twIm);
+            for (; j < prev; j++)
+                radix2<ScalarVec>(re + b, im + b, j, prev, twRe, twIm);
+        }
+    }
+
+    static void radix4Stage(double *re, double *im, size_t n, size_t prev,
+                            const double *twRe, const double *twIm, double sign)
+    {
+        for (size_t b = 0; b < n; b += 4 * prev)
+        {
+            size_t j = 0;
+            for (; j + V::width <= prev; j += V::width)
+                radix4<V>(re + b, im + b, j, prev, twRe, twIm, sign);
+            for (; j < prev; j++)
+                radix4<ScalarVec>(re + b, im + b, j, prev, twRe, twIm, sign);
+        }
+    }
+
+    static void complexMultiplyInterleaved(std::complex<double> *a, const std::complex<double> *b, size_t n)
+    {
+        double *pa = reinterpret_cast<double *>(a);
+        const double *pb = reinterpret_cast<const double *>(b);
+        size_t k = 0;
+        for (; k + V::width <= n; k += V::width)
+        {
+            T aRe, aIm, bRe, bIm, r, i;
+            V::deinterleave(pa + 2 * k, aRe, aIm);
+            V::deinterleave(pb + 2 * k, bRe, bIm);
+            cmul(aRe, aIm, bRe, bIm, r, i);
+            V::interleave(pa + 2 * k, r, i);
+        }
+        for (; k < n; k++)
+        {
+            double r = pa[2 * k] * pb[2 * k] - pa[2 * k + 1] * pb[2 * k + 1];
+            pa[2 * k + 1] = pa[2 * k] * pb[2 * k + 1] + pa[2 * k + 1] * pb[2 * k];
+            pa[2 * k] = r;
+        }
+    }
+
+    static void accumulatePowerInterleaved(const std::complex<double> *in, double *sum, size_t n)
+    {
+        const double *p = reinterpret_cast<const double *>(in);
+        size_t k = 0;
+        for (; k + V::width <= n; k += V::width)
+        {
+            T r, i;
+            V::deinterleave(p + 2 * k, r, i);
+            V::store(sum + k, V::fmadd(r, r, V::fmadd(i, i, V::load(sum + k))));
+        }
+        for (; k < n; k++)
+            sum[k] += p[2 * k] * p[2 * k] + p[2 * k + 1] * p[2 * k + 1];
+    }
+
+    static void magnitude(const double *re, const double *im, double *out, size_t n)
+    {
+        size_t k = 0;
+        for (; k + V::width <= n; k += V::width)
+        {
+            T r = V::load(re + k), i = V::load(im + k);
+            V::store(out + k, V::sqrt(V::fmadd(r, r, V::mul(i, i))));
+        }
+        for (; k < n; k++)
+            out[k] = std::sqrt(re[k] * re[k] + im[k] * im[k]);
+    }
+
+    static void magnitudeInterleaved(const std::complex<double> *in, double *out, size_t n)
+    {
+        const double *p = reinterpret_cast<const double *>(in);
+        size_t k = 0;
+        for (; k + V::width <= n; k += V::width)
+        {
+            T r, i;
+            V::deinterleave(p + 2 * k, r, i);
+            V::store(out + k, V::sqrt(V::fmadd(r, r, V::mul(i, i))));
+        }
+        for (; k < n; k++)
+            out[k] = std::sqrt(p[2 * k] * p[2 * k] + p[2 * k + 1] * p[2 * k + 1]);
+    }
+
+    static SimdKernels table(const char *name)
+    {
+        return {name, radix2Stage, radix4Stage, magnitude, magnitudeInterleaved, complexMultiplyInterleaved,
+                accumulatePowerInterleaved};
+    }
+};
+
+} // namespace
+
+#endif // SIMD_IMPL_H
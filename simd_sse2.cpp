@@ -0,0 +1,41 @@
+// Compiled with -msse2, see CMakeLists.txt
+#include <emmintrin.h>
+#include "simd_impl.h"
+
+namespace
+{
+
+struct Sse2Vec
+{
+    using type = __m128d;
+    static constexpr size_t width = 2;
+
+    static type load(const double *p) { return _mm_loadu_pd(p); }
+    static void store(double *p, type v) { _mm_storeu_pd(p, v); }
+    static type set1(double v) { return _mm_set1_pd(v); }
+    static type add(type a, type b) { return _mm_add_pd(a, b); }
+    static type sub(type a, type b) { return _mm_sub_pd(a, b); }
+    static type mul(type a, type b) { return _mm_mul_pd(a, b); }
+    static type fmadd(type a, type b, type c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+    static type fmsub(type a, type b, type c) { return _mm_sub_pd(_mm_mul_pd(a, b), c); }
+    static type sqrt(type a) { return _mm_sqrt_pd(a); }
+    static void deinterleave(const double *p, type &re, type &im)
+    {
+        type a = _mm_loadu_pd(p), b = _mm_loadu_pd(p + 2);
+        re = _mm_unpacklo_pd(a, b);
+        im = _mm_unpackhi_pd(a, b);
+    }
+    static void interleave(double *p, type re, type im)
+    {
+        _mm_storeu_pd(p, _mm_unpacklo_pd(re, im));
+        _mm_storeu_pd(p + 2, _mm_unpackhi_pd(re, im));
+    }
+};
+
+} // namespace
+
+const SimdKernels &sse2Kernels()
+{
+    static const SimdKernels kernels = SimdImpl<Sse2Vec>::table("sse2");
+    return kernels;
+}
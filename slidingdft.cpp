@@ -0,0 +1,78 @@
+#include "slidingdft.h"
+#include "spectrum.h"
+#include <algorithm>
+#include <cmath>
+
+SlidingDFT::SlidingDFT(size_t size, double damping)
+    : re(size / 2 + 1), im(size / 2 + 1), wr(size / 2 + 1), wi(size / 2 + 1), history(size),
+      oldestWeight(std::pow(damping, static_cast<double>(size))),
+      amplitudeScale(sineAmplitudeScale(size, WindowType::Hann))
+{
+    for (size_t k = 0; k < bins(); k++)
+    {
+        double angle = 2.0 * M_PI * static_cast<double>(k) / static_cast<double>(size);
+        wr[k] = damping * std::cos(angle);
+        wi[k] = damping * std::sin(angle);
+    }
+}
+
+void SlidingDFT::add(const double *samples, size_t count)
+{
+    const size_t n = size();
+    const size_t k = bins();
+    if (n == 0)
+        return;
+
+    double *bre = re.data();
+    double *bim = im.data();
+    const double *twr = wr.data();
+    const double *twi = wi.data();
+    for (size_t i = 0; i < count; i++)
+    {
+        double delta = samples[i] - oldestWeight * history[position];
+        history[position] = samples[i];
+        if (++position == n)
+            position = 0;
+
+        for (size_t j = 0; j < k; j++)
+        {
+            double r = bre[j] + delta;
+            double m = bim[j];
+            bre[j] = r * twr[j] - m * twi[j];
+            bim[j] = r * twi[j] + m * twr[j];
+        }
+    }
+}
+
+void SlidingDFT::reset()
+{
+    std::fill(re.begin(), re.end(), 0.0);
+    std::fill(im.begin(), im.end(), 0.0);
+    std::fill(history.begin(), history.end(), 0.0);
+    position = 0;
+}
+
+void SlidingDFT::amplitudes(double *out) const
+{
+    const size_t n = size();
+    const size_t k = bins();
+    if (n < 2)
+    {
+        std::fill(out, out + k, 0.0);
+        return;
+    }
+
+    // Hann: 0.5 X[k] - 0.25 (X[k-1] + X[k+1]); the bins below 0 and above n/2 are the
+    // conjugates of the ones inside
+    for (size_t j = 0; j < k; j++)
+    {
+        size_t below = j > 0 ? j - 1 : 1;
+        size_t above = j + 1 < k ? j + 1 : n - j - 1;
+        double belowIm = j > 0 ? im[below] : -im[below];
+        double aboveIm = j + 1 < k ? im[above] : -im[above];
+        double r = 0.5 * re[j] - 0.25 * (re[below] + re[above]);
+        double m = 0.5 * im[j] - 0.25 * (belowIm + aboveIm);
+        out[j] = std::hypot(r, m);
+    }
+    scaleToSineAmplitudes(out, k, n, amplitudeScale);
+}
@@ -0,0 +1,39 @@
+#ifndef SLIDINGDFT_H
+#define SLIDINGDFT_H
+#include <cstddef>
+#include <vector>
+
+// Spectrum of the last `size` samples of a stream, updated sample by sample.
+// Each bin follows the recursion X[k] = r * exp(2*pi*i * k / size) * (X[k] + x[n] - r^size * x[n - size]),
+// O(bins) per sample instead of an FFT per frame. The damping r < 1 makes rounding errors
+// die out instead of accumulating forever; it slightly weights older samples less, which
+// does not show at display precision. Bins sit side by side so the update vectorizes.
+class SlidingDFT
+{
+public:
+    explicit SlidingDFT(size_t size, double damping = 0.9999999);
+
+    // Feed the next samples of the stream
+    void add(const double *samples, size_t count);
+
+    // Forget the stream, as if only zeros had been seen
+    void reset();
+
+    size_t size() const { return history.size(); }
+    // Non-negative frequency bins, size / 2 + 1
+    size_t bins() const { return re.size(); }
+
+    // Sine amplitude per bin of the last size samples under a Hann window
+    // (applied in the frequency domain), the same scale as the analysed spectrum
+    void amplitudes(double *out) const;
+
+private:
+    std::vector<double> re, im;   // Bins
+    std::vector<double> wr, wi;   // r * exp(2*pi*i * k / size)
+    std::vector<double> history;  // Last size samples, circular
+    size_t position = 0;          // Oldest sample in history
+    double oldestWeight;          // r^size
+    double amplitudeScale;        // |X[k]| to sine amplitude under the Hann window
+};
+
+#endif // SLIDINGDFT_H
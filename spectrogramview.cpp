@@ -0,0 +1,119 @@
+#include "spectrogramview.h"
+
+#include <QPainter>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+
+// Black - purple - orange - pale yellow, like the "inferno" map
+QRgb colourAt(double t)
+{
+    static const double stops[][3] = {
+        {0, 0, 4}, {87, 16, 110}, {188, 55, 84}, {249, 142, 9}, {252, 255, 164}};
+    constexpr int last = 4;
+    t = std::clamp(t, 0.0, 1.0) * last;
+    int i = std::min(static_cast<int>(t), last - 1);
+    double f = t - i;
+    return qRgb(static_cast<int>(stops[i][0] + f * (stops[i + 1][0] - stops[i][0])),
+                static_cast<int>(stops[i][1] + f * (stops[i + 1][1] - stops[i][1])),
+                static_cast<int>(stops[i][2] + f * (stops[i + 1][2] - stops[i][2])));
+}
+
+// Colour table computed once, indexed by the level scaled to 0..255
+const QRgb *palette()
+{
+    static const auto table = [] {
+        std::array<QRgb, 256> colours;
+        for (int i = 0; i < 256; i++)
+            colours[i] = colourAt(i / 255.0);
+        return colours;
+    }();
+    return table.data();
+}
+
+} // namespace
+
+SpectrogramView::SpectrogramView(QWidget *parent)
+    : QWidget(parent)
+{
+    setMinimumHeight(60);
+}
+
+void SpectrogramView::setSpectrogram(std::shared_ptr<const Spectrogram> newSpectrogram)
+{
+    spectrogram = std::move(newSpectrogram);
+    render();
+    update();
+}
+
+void SpectrogramView::setRange(float floor, float ceiling)
+{
+    floorDb = floor;
+    ceilingDb = ceiling;
+    render();
+    update();
+}
+
+void SpectrogramView::render()
+{
+    if (!spectrogram || spectrogram->frames == 0 || spectrogram->bins == 0)
+    {
+        image = QImage();
+        return;
+    }
+
+    const Spectrogram &s = *spectrogram;
+    const int columns = static_cast<int>(std::min<size_t>(s.frames, MAX_COLUMNS));
+    const int rows = static_cast<int>(std::min<size_t>(s.bins, MAX_ROWS));
+    image = QImage(columns, rows, QImage::Format_RGB32);
+
+    const QRgb *colours = palette();
+    const float scale = 255.0f / std::max(ceilingDb - floorDb, 1e-3f);
+    for (int row = 0; row < rows; row++)
+    {
+        // Row 0 is the top of the image, the highest frequencies
+        size_t binBegin = (rows - 1 - row) * s.bins / rows;
+        size_t binEnd = std::max(binBegin + 1, (rows - row) * s.bins / rows);
+        QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(row));
+        for (int column = 0; column < columns; column++)
+        {
+            size_t frameBegin = column * s.frames / columns;
+            size_t frameEnd = std::max(frameBegin + 1, (column + 1) * s.frames / columns);
+
+            float loudest = -std::numeric_limits<float>::infinity();
+            for (size_t frame = frameBegin; frame < frameEnd; frame++)
+            {
+                const float *levels = &s.levels[frame * s.bins];
+                for (size_t bin = binBegin; bin < binEnd; bin++)
+                    loudest = std::max(loudest, levels[bin]);
+            }
+            int index = static_cast<int>((loudest - floorDb) * scale);
+            line[column] = colours[std::clamp(index, 0, 255)];
+        }
+    }
+}
+
+void SpectrogramView::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), Qt::black);
+    if (image.isNull())
+        return;
+
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
+    painter.drawImage(rect(), image);
+
+    // Axis extents in the corners
+    const Spectrogram &s = *spectrogram;
+    painter.setPen(Qt::white);
+    QRect area = rect().adjusted(4, 2, -4, -2);
+    painter.drawText(area, Qt::AlignTop | Qt::AlignLeft, QString("%1 Hz").arg(s.sampleRate / 2));
+    painter.drawText(area, Qt::AlignBottom | Qt::AlignLeft, "0 Hz");
+    double duration = s.frameTime(s.frames - 1) + s.frameSize / s.sampleRate;
+    painter.drawText(area, Qt::AlignBottom | Qt::AlignRight, QString("%1 s").arg(duration, 0, 'f', 2));
+}
@@ -0,0 +1,40 @@
+#ifndef SPECTROGRAMVIEW_H
+#define SPECTROGRAMVIEW_H
+#include <QWidget>
+#include <QImage>
+
+#include <memory>
+
+#include "stft.h"
+
+// Heat map of a Spectrogram: time to the right, frequency upwards, level as colour.
+// The levels are rendered once into a QImage of at most MAX_COLUMNS x MAX_ROWS pixels (cells
+// covering several frames or bins keep their loudest one, so short events stay visible) and
+// the image is scaled to the widget when painting.
+class SpectrogramView : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit SpectrogramView(QWidget *parent = nullptr);
+
+    void setSpectrogram(std::shared_ptr<const Spectrogram> spectrogram);
+
+    // Levels mapped to the colour scale, quieter ones are black
+    void setRange(float floorDb, float ceilingDb);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    static constexpr int MAX_COLUMNS = 2048;
+    static constexpr int MAX_ROWS = 1024;
+
+    void render();
+
+    std::shared_ptr<const Spectrogram> spectrogram;
+    QImage image;
+    float floorDb = -120.0f;
+    float ceilingDb = 0.0f;
+};
+
+#endif // SPECTROGRAMVIEW_H
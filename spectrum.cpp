@@ -0,0 +1,65 @@
+#include "spectrum.h"
+#include "fft.h"
+#include "simd.h"
+#include <algorithm>
+
+std::vector<std::complex<double>> realDFT(std::vector<double> samples, size_t length, WindowType window)
+{
+    if (samples.empty() || length == 0)
+        return {};
+
+    const size_t count = std::min(samples.size(), length);
+    samples.resize(length, 0.0);
+
+    // https://en.wikipedia.org/wiki/Discrete_Fourier_transform#Example_2
+    // computed in O(N log N), see fft.h for the accuracy against the direct summation
+    if (window == WindowType::Rectangular)
+        return rfft(samples);
+
+    // The window spans the samples, not the zero padding
+    std::shared_ptr<const Window> table = Window::get(window, count);
+    if (count == length)
+        return rfft(samples.data(), length, table->data()); // Applied inside the FFT input pass
+
+    for (size_t i = 0; i < count; i++)
+        samples[i] *= (*table)[i];
+    return rfft(samples);
+}
+
+std::vector<std::complex<double>> mirrorSpectrum(const std::vector<std::complex<double>> &half, size_t length)
+{
+    if (half.empty())
+        return {};
+
+    std::vector<std::complex<double>> full(length);
+    std::copy(half.begin(), half.begin() + std::min(half.size(), length), full.begin());
+    for (size_t k = half.size(); k < length; k++)
+        full[k] = std::conj(full[length - k]);
+    return full;
+}
+
+double sineAmplitudeScale(size_t windowLength, WindowType window)
+{
+    if (windowLength == 0)
+        return 0.0;
+    return 2.0 / (windowLength * Window::get(window, windowLength)->coherentGain());
+}
+
+void scaleToSineAmplitudes(double *magnitudes, size_t bins, size_t length, double scale)
+{
+    for (size_t k = 0; k < bins; k++)
+        magnitudes[k] *= scale;
+    if (bins == 0)
+        return;
+    magnitudes[0] *= 0.5;
+    if (length > 0 && length % 2 == 0 && length / 2 < bins)
+        magnitudes[length / 2] *= 0.5;
+}
+
+std::vector<double> sineAmplitudes(const std::vector<std::complex<double>> &half, size_t length, double scale)
+{
+    std::vector<double> amplitudes(half.size());
+    simdKernels().magnitudeInterleaved(half.data(), amplitudes.data(), amplitudes.size());
+    scaleToSineAmplitudes(amplitudes.data(), amplitudes.size(), length, scale);
+    return amplitudes;
+}
@@ -0,0 +1,30 @@
+#ifndef SPECTRUM_H
+#define SPECTRUM_H
+#include <complex>
+#include <cstddef>
+#include <vector>
+#include "window.h"
+
+// Non-redundant half (bins 0..length/2) of the DFT of real samples over length points.
+// The samples are cut or zero-padded to length and the window spans the samples only, not
+// the padding. Signal::getRealDFT takes length = sampleRate, so the bins are 1 Hz apart.
+std::vector<std::complex<double>> realDFT(std::vector<double> samples, size_t length,
+                                          WindowType window = WindowType::Rectangular);
+
+// Full length-point DFT of real samples from its half (see realDFT),
+// the upper bins being the complex conjugates X[length-k] = conj(X[k])
+std::vector<std::complex<double>> mirrorSpectrum(const std::vector<std::complex<double>> &half, size_t length);
+
+// Factor that turns |X[k]| into the amplitude of a sine in bin k, for a DFT of windowLength
+// samples weighted by window: such a sine peaks at A * coherentGain * windowLength / 2. 0 if empty
+double sineAmplitudeScale(size_t windowLength, WindowType window);
+
+// Magnitudes of the bins of a half spectrum over length points into sine amplitudes, in place:
+// multiplied by scale and halved at DC and Nyquist, which have no mirrored half
+void scaleToSineAmplitudes(double *magnitudes, size_t bins, size_t length, double scale);
+
+// Sine amplitude per bin of a half spectrum over length points (see realDFT), the charts' and
+// files' scale. scale comes from sineAmplitudeScale of the samples the DFT was taken over
+std::vector<double> sineAmplitudes(const std::vector<std::complex<double>> &half, size_t length, double scale);
+
+#endif // SPECTRUM_H
@@ -0,0 +1,101 @@
+#include "stft.h"
+#include "samplesource.h"
+#include "fft.h"
+#include "scratch.h"
+#include "simd.h"
+#include "spectrum.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+namespace
+{
+
+// Lowest level stored, about the noise floor of double precision transforms
+constexpr float FLOOR_DB = -200.0f;
+
+// Frames come from frame(start, scratch), which returns frameSize samples from start on,
+// zero-padded past count, either in place or written into scratch
+template <class FrameReader>
+Spectrogram transformFrames(size_t count, double sampleRate, size_t frameSize, size_t hop, WindowType window,
+                            const std::atomic<bool> *cancel, const FrameReader &frame)
+{
+    Spectrogram result;
+    if (count == 0 || frameSize == 0 || hop == 0 || sampleRate <= 0)
+        return result;
+
+    result.frames = count <= frameSize ? 1 : 1 + (count - frameSize + hop - 1) / hop;
+    result.bins = frameSize / 2 + 1;
+    result.sampleRate = sampleRate;
+    result.frameSize = frameSize;
+    result.hop = hop;
+    result.levels.resize(result.frames * result.bins);
+
+    std::shared_ptr<const RealFFTPlan> plan = RealFFTPlan::get(frameSize);
+    std::shared_ptr<const Window> table = Window::get(window, frameSize);
+    const double scale = sineAmplitudeScale(frameSize, window);
+
+    ThreadPool::shared().parallelFor(result.frames, [&](size_t begin, size_t end) {
+        // Long frames transform in parallel, see scratch.h for why these are not thread_local
+        ScratchBuffer<double> frameScratch(frameSize);
+        ScratchBuffer<std::complex<double>> binScratch(result.bins);
+        ScratchBuffer<double> amplitudeScratch(result.bins);
+        for (size_t index = begin; index < end; index++)
+        {
+            if (cancel && *cancel)
+                return;
+
+            const double *in = frame(index * hop, frameScratch.data());
+            plan->execute(in, binScratch.data(), table->data());
+
+            double *amplitudes = amplitudeScratch.data();
+            simdKernels().magnitudeInterleaved(binScratch.data(), amplitudes, result.bins);
+            scaleToSineAmplitudes(amplitudes, result.bins, frameSize, scale);
+
+            float *row = &result.levels[index * result.bins];
+            for (size_t k = 0; k < result.bins; k++)
+                row[k] = amplitudes[k] > 0
+                             ? std::max(FLOOR_DB, static_cast<float>(20.0 * std::log10(amplitudes[k])))
+                             : FLOOR_DB;
+        }
+    }, 4);
+
+    if (cancel && *cancel)
+        return Spectrogram();
+    return result;
+}
+
+} // namespace
+
+Spectrogram stft(const double *samples, size_t count, double sampleRate, size_t frameSize, size_t hop,
+                 WindowType window, const std::atomic<bool> *cancel)
+{
+    return transformFrames(count, sampleRate, frameSize, hop, window, cancel,
+                           [=](size_t start, double *scratch) {
+        // Full frames are read in place, the last one is copied and zero-padded
+        const double *in = samples + start;
+        if (start + frameSize <= count)
+            return in;
+        size_t available = count - start;
+        std::copy(in, in + available, scratch);
+        std::fill(scratch + available, scratch + frameSize, 0.0);
+        return static_cast<const double *>(scratch);
+    });
+}
+
+Spectrogram stft(const SampleSource &source, size_t frameSize, size_t hop, WindowType window,
+                 const std::atomic<bool> *cancel)
+{
+    if (const double *samples = source.data())
+        return stft(samples, source.size(), source.sampleRate(), frameSize, hop, window, cancel);
+
+    const size_t count = source.size();
+    return transformFrames(count, source.sampleRate(), frameSize, hop, window, cancel,
+                           [&](size_t start, double *scratch) {
+        size_t available = std::min(frameSize, count - start);
+        source.read(start, start + available, scratch);
+        std::fill(scratch + available, scratch + frameSize, 0.0);
+        return static_cast<const double *>(scratch);
+    });
+}
@@ -0,0 +1,39 @@
+#ifndef STFT_H
+#define STFT_H
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "window.h"
+
+class SampleSource;
+
+// Spectrum over time: frames of frameSize samples every hop samples, one row of levels per frame
+struct Spectrogram
+{
+    size_t frames = 0;
+    size_t bins = 0;           // frameSize/2 + 1
+    double sampleRate = 0;
+    size_t frameSize = 0;
+    size_t hop = 0;
+    std::vector<float> levels; // frames * bins, dB relative to a sine of amplitude 1
+
+    float level(size_t frame, size_t bin) const { return levels[frame * bins + bin]; }
+    double binFrequency(size_t bin) const { return bin * sampleRate / frameSize; }
+    double frameTime(size_t frame) const { return frame * hop / sampleRate; } // Start of the frame
+};
+
+// Short-time Fourier transform of samples[0, count).
+// Frames are windowed (fused into the FFT input, see RealFFTPlan::execute) and transformed in
+// parallel on ThreadPool::shared(), every thread reusing the shared plan and its own scratch.
+// The last frame is zero-padded, a signal shorter than frameSize still gives one frame.
+// Levels are window-corrected like the DFT chart: a sine of amplitude A reads 20*log10(A) in
+// its bin. Returns an empty spectrogram if cancel becomes true before the end.
+Spectrogram stft(const double *samples, size_t count, double sampleRate, size_t frameSize, size_t hop,
+                 WindowType window, const std::atomic<bool> *cancel = nullptr);
+
+// Same over a whole source, each thread reading its frames from it as it goes
+Spectrogram stft(const SampleSource &source, size_t frameSize, size_t hop, WindowType window,
+                 const std::atomic<bool> *cancel = nullptr);
+
+#endif // STFT_H
@@ -0,0 +1,262 @@
+#include "synth.h"
+#include <algorithm>
+#include <cmath>
+
+// frequency * n / sampleRate reaches billions of cycles in long signals, so it is split
+// exactly with fma: frequency * n = hi + lo and hi = q * sampleRate + r, then only the
+// fraction of q (exact) and the small (r + lo) / sampleRate are kept
+double phaseAt(double frequency, double phase, double sampleRate, size_t n)
+{
+    double samples = static_cast<double>(n);
+    double hi = frequency * samples;
+    double lo = std::fma(frequency, samples, -hi);
+    double q = hi / sampleRate;
+    double r = std::fma(-q, sampleRate, hi);
+    double cycles = (q - std::floor(q)) + (r + lo) / sampleRate;
+    return 2.0 * M_PI * cycles + phase;
+}
+
+namespace
+{
+
+// Tones advanced together, one partial sum each
+constexpr size_t LANES = 4;
+
+// Reused between calls on the same thread, so synthesizing in chunks does not allocate
+thread_local SynthRotators rotators;
+
+// Size the rotators for tones and set their steps, return the padded count
+size_t prepare(SynthRotators &rot, const OvertoneBank &bank, double sampleRate)
+{
+    const size_t tones = bank.size();
+    const size_t padded = (tones + LANES - 1) / LANES * LANES;
+    rot.re.assign(padded, 0.0);
+    rot.im.assign(padded, 0.0);
+    rot.wr.assign(padded, 1.0);
+    rot.wi.assign(padded, 0.0);
+    for (size_t k = 0; k < tones; k++)
+    {
+        double step = 2.0 * M_PI * bank.frequency[k] / sampleRate;
+        rot.wr[k] = std::cos(step);
+        rot.wi[k] = std::sin(step);
+    }
+    return padded;
+}
+
+// Add length samples of the seeded rotators to out, LANES tones at a time
+// over the whole run so the output stays in L1
+void run(const SynthRotators &rot, size_t padded, double *out, size_t length)
+{
+    for (size_t k = 0; k < padded; k += LANES)
+    {
+        double zr[LANES], zi[LANES], cr[LANES], ci[LANES];
+        for (size_t l = 0; l < LANES; l++)
+        {
+            zr[l] = rot.re[k + l];
+            zi[l] = rot.im[k + l];
+            cr[l] = rot.wr[k + l];
+            ci[l] = rot.wi[k + l];
+        }
+        for (size_t n = 0; n < length; n++)
+        {
+            out[n] += (zr[0] + zr[1]) + (zr[2] + zr[3]);
+            for (size_t l = 0; l < LANES; l++)
+            {
+                double r = zr[l] * cr[l] - zi[l] * ci[l];
+                zi[l] = zr[l] * ci[l] + zi[l] * cr[l];
+                zr[l] = r;
+            }
+        }
+    }
+}
+
+} // namespace
+
+void OvertoneBank::clear()
+{
+    amplitude.clear();
+    frequency.clear();
+    phase.clear();
+}
+
+void OvertoneBank::add(double a, double f, double p)
+{
+    amplitude.push_back(a);
+    frequency.push_back(f);
+    phase.push_back(p);
+}
+
+double OvertoneBank::value(double time) const
+{
+    double value = 0.0;
+    for (size_t k = 0; k < size(); k++)
+    {
+        value += amplitude[k] * std::cos(2 * M_PI * frequency[k] * time + phase[k]);
+    }
+    return value;
+}
+
+void synthesize(const OvertoneBank &bank, double sampleRate, size_t begin, size_t end, double *out)
+{
+    if (end <= begin)
+        return;
+    if (sampleRate <= 0 || bank.size() == 0)
+    {
+        std::fill(out, out + (end - begin), 0.0);
+        return;
+    }
+
+    const size_t tones = bank.size();
+    SynthRotators &rot = rotators;
+    const size_t padded = prepare(rot, bank, sampleRate);
+
+    // Blocks are aligned on absolute sample numbers, so chunks starting on a block boundary
+    // give the same values as sampling at once; other chunks differ by rounding only
+    std::fill(out, out + (end - begin), 0.0);
+    for (size_t block = begin; block < end;)
+    {
+        size_t blockEnd = std::min(end, (block / SYNTH_BLOCK + 1) * SYNTH_BLOCK);
+
+        // Exact seed at the start of the block
+        for (size_t k = 0; k < tones; k++)
+        {
+            double theta = phaseAt(bank.frequency[k], bank.phase[k], sampleRate, block);
+            rot.re[k] = bank.amplitude[k] * std::cos(theta);
+            rot.im[k] = bank.amplitude[k] * std::sin(theta);
+        }
+        run(rot, padded, out + (block - begin), blockEnd - block);
+        block = blockEnd;
+    }
+}
+
+void ToneSet::assign(const OvertoneBank &bank)
+{
+    count = std::min(bank.size(), SYNTH_MAX_TONES);
+    std::copy(bank.amplitude.begin(), bank.amplitude.begin() + count, amplitude);
+    std::copy(bank.frequency.begin(), bank.frequency.begin() + count, frequency);
+    std::copy(bank.phase.begin(), bank.phase.begin() + count, phase);
+}
+
+void StreamingSynth::reserve(Voice &voice, size_t tones)
+{
+    // Room for any ToneSet, so setTones never allocates
+    size_t capacity = std::max(tones, SYNTH_MAX_TONES) + LANES;
+    voice.bank.amplitude.reserve(capacity);
+    voice.bank.frequency.reserve(capacity);
+    voice.bank.phase.reserve(capacity);
+    voice.cycles.reserve(capacity);
+    voice.state.re.reserve(capacity);
+    voice.state.im.reserve(capacity);
+    voice.state.wr.reserve(capacity);
+    voice.state.wi.reserve(capacity);
+}
+
+void StreamingSynth::reset(const OvertoneBank &tones, double rate)
+{
+    sampleRate = rate;
+    position = 0;
+    current = 0;
+    rampLength = rampDone = 0;
+
+    for (Voice &voice : voices)
+        reserve(voice, tones.size());
+
+    Voice &voice = voices[current];
+    voice.bank = tones;
+    voice.cycles.assign(tones.size(), 0.0);
+    voice.padded = sampleRate > 0 ? prepare(voice.state, voice.bank, sampleRate) : 0;
+}
+
+void StreamingSynth::restart()
+{
+    // A pending crossfade is completed at once
+    if (isRamping())
+    {
+        current = 1 - current;
+        rampLength = rampDone = 0;
+    }
+    Voice &voice = voices[current];
+    std::fill(voice.cycles.begin(), voice.cycles.end(), 0.0);
+    position = 0;
+}
+
+void StreamingSynth::setTones(const ToneSet &tones, size_t rampSamples)
+{
+    // A crossfade in progress jumps to its end, callers wait for isRamping() to avoid that
+    if (isRamping())
+    {
+        current = 1 - current;
+        rampLength = rampDone = 0;
+    }
+
+    const Voice &from = voices[current];
+    Voice &to = voices[1 - current];
+    to.bank.clear();
+    to.cycles.clear();
+    for (size_t k = 0; k < tones.count; k++)
+    {
+        to.bank.add(tones.amplitude[k], tones.frequency[k], tones.phase[k]);
+        to.cycles.push_back(k < from.cycles.size() ? from.cycles[k] : 0.0);
+    }
+    to.padded = sampleRate > 0 ? prepare(to.state, to.bank, sampleRate) : 0;
+
+    if (rampSamples == 0)
+        current = 1 - current;
+    else
+        rampLength = rampSamples;
+}
+
+void StreamingSynth::renderVoice(Voice &voice, double *out, size_t count)
+{
+    if (voice.padded == 0)
+        return;
+
+    const OvertoneBank &bank = voice.bank;
+    for (size_t done = 0; done < count;)
+    {
+        size_t length = std::min(count - done, SYNTH_BLOCK);
+
+        // Seed from the running phase, then advance it by the rendered samples
+        for (size_t k = 0; k < bank.size(); k++)
+        {
+            double theta = 2.0 * M_PI * voice.cycles[k] + bank.phase[k];
+            voice.state.re[k] = bank.amplitude[k] * std::cos(theta);
+            voice.state.im[k] = bank.amplitude[k] * std::sin(theta);
+            double next = voice.cycles[k] + bank.frequency[k] * static_cast<double>(length) / sampleRate;
+            voice.cycles[k] = next - std::floor(next);
+        }
+        run(voice.state, voice.padded, out + done, length);
+        done += length;
+    }
+}
+
+void StreamingSynth::render(double *out, size_t count)
+{
+    std::fill(out, out + count, 0.0);
+
+    size_t done = 0;
+    while (isRamping() && done < count)
+    {
+        // Linear crossfade from the current voice to the incoming one
+        size_t length = std::min({count - done, rampLength - rampDone, SYNTH_BLOCK});
+        std::fill(fadeBuffer, fadeBuffer + length, 0.0);
+        renderVoice(voices[current], fadeBuffer, length);
+        renderVoice(voices[1 - current], out + done, length);
+        for (size_t i = 0; i < length; i++)
+        {
+            double gain = static_cast<double>(rampDone + i + 1) / rampLength;
+            out[done + i] = gain * out[done + i] + (1.0 - gain) * fadeBuffer[i];
+        }
+        done += length;
+        rampDone += length;
+
+        if (rampDone == rampLength)
+        {
+            current = 1 - current;
+            rampLength = rampDone = 0;
+        }
+    }
+
+    renderVoice(voices[current], out + done, count - done);
+    position += count;
+}
@@ -0,0 +1,119 @@
+#ifndef SYNTH_H
+#define SYNTH_H
+#include <cstddef>
+#include <vector>
+
+// Structure-of-arrays view of a set of cosine tones: amplitude * cos(2*pi * frequency * t + phase).
+// Parameters sit in contiguous arrays (names stay with the overtones they were built from)
+// so that loops over the tones stream through memory and vectorize.
+struct OvertoneBank
+{
+    std::vector<double> amplitude;
+    std::vector<double> frequency; // Hz
+    std::vector<double> phase;     // Radians
+
+    size_t size() const { return amplitude.size(); }
+    void clear();
+    void add(double amplitude, double frequency, double phase);
+
+    // Sum of the tones at a given time, evaluated with std::cos (the reference)
+    double value(double time) const;
+};
+
+// Write the sum of the tones at samples [begin, end) of a signal sampled at sampleRate into out.
+//
+// Instead of one std::cos per tone per sample every tone runs as a complex rotator
+// z[n+1] = z[n] * exp(i * 2*pi * frequency / sampleRate). The rotators of the tones are
+// stored side by side and advanced four tones at a time, one tone per SIMD lane, over a
+// whole block of output. Rotators are re-seeded with an exact cos/sin every SYNTH_BLOCK samples,
+// which keeps the rounding drift bounded no matter how long the signal is.
+//
+// Accuracy (checked by tests/synth_test.cpp): the result stays within 1e-12 * sum(|amplitude|)
+// of the exact sum for any length, observed below 1e-13 * sum(|amplitude|). A plain std::cos
+// sum like OvertoneBank::value rounds 2*pi*f*t itself and is off by up to about
+// 1e-16 * 2*pi*f*t per unit of amplitude: for 50 tones up to 20 kHz over 10 s the two differ
+// by up to 5e-11 * sum(|amplitude|), the error being the reference's.
+// Chunks starting on a multiple of SYNTH_BLOCK give exactly the samples of a single call,
+// chunks starting anywhere else agree with it to the same bound.
+void synthesize(const OvertoneBank &bank, double sampleRate, size_t begin, size_t end, double *out);
+
+// Phase of a tone at sample n, 2*pi * frequency * n / sampleRate + phase, with the cycles
+// reduced to one period exactly before the initial phase is added
+double phaseAt(double frequency, double phase, double sampleRate, size_t n);
+
+// Samples between two exact re-seeds of the rotators
+constexpr size_t SYNTH_BLOCK = 1024;
+
+// Rotator state of a set of tones, padded to a multiple of the vector width with silent tones
+struct SynthRotators
+{
+    std::vector<double> re, im; // amplitude * exp(i * phase) at the current sample
+    std::vector<double> wr, wi; // exp(i * 2*pi * frequency / sampleRate)
+};
+
+// Tones a playing StreamingSynth can switch to without allocating
+constexpr size_t SYNTH_MAX_TONES = 256;
+
+// Fixed-size copy of tone parameters, so that it can be handed to the audio thread
+// without allocating (tones beyond SYNTH_MAX_TONES are dropped)
+struct ToneSet
+{
+    size_t count = 0;
+    double amplitude[SYNTH_MAX_TONES];
+    double frequency[SYNTH_MAX_TONES];
+    double phase[SYNTH_MAX_TONES];
+
+    void assign(const OvertoneBank &bank);
+};
+
+// Oscillators for streaming playback: instead of absolute sample numbers they keep
+// a running phase per tone, so any number of samples can be rendered at a time
+// with constant memory and no end. Uses the same rotators as synthesize().
+class StreamingSynth
+{
+public:
+    // Start the tones at their initial phases
+    void reset(const OvertoneBank &bank, double sampleRate);
+
+    // Go back to the first sample with the current tones
+    void restart();
+
+    // Crossfade from the current tones to new ones over rampSamples.
+    // Tone k continues the running phase of the current tone k, so a frequency change
+    // does not jump. Safe on a real-time thread: no allocation, no locks.
+    void setTones(const ToneSet &tones, size_t rampSamples);
+
+    // True while a crossfade started by setTones is in progress
+    bool isRamping() const { return rampLength > 0; }
+
+    // Render the next count samples
+    void render(double *out, size_t count);
+
+    // Number of samples rendered since the last reset or restart
+    size_t getPosition() const { return position; }
+
+private:
+    // One set of running oscillators
+    struct Voice
+    {
+        OvertoneBank bank;
+        std::vector<double> cycles; // Running phase of each tone in cycles, [0, 1)
+        SynthRotators state;
+        size_t padded = 0;
+    };
+
+    void reserve(Voice &voice, size_t tones);
+    // Add count samples of the voice to out and advance its phases
+    void renderVoice(Voice &voice, double *out, size_t count);
+
+    Voice voices[2];
+    int current = 0; // Voice heard when not ramping, the one fading out while ramping
+    size_t rampLength = 0;
+    size_t rampDone = 0;
+    double fadeBuffer[SYNTH_BLOCK];
+
+    double sampleRate = 0;
+    size_t position = 0;
+};
+
+#endif // SYNTH_H
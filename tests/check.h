@@ -0,0 +1,36 @@
+#ifndef CHECK_H
+#define CHECK_H
+#include <cstdio>
+
+// Minimal checks for the ctest executables: a failed CHECK prints its location and message and
+// marks the test failed, the test keeps going so that one run reports every failure.
+// main() returns checkResult(), non-zero when anything failed.
+
+inline int &checkFailures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition, ...)                                                                  \
+    do                                                                                         \
+    {                                                                                          \
+        if (!(condition))                                                                      \
+        {                                                                                      \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed: ", __FILE__, __LINE__, #condition); \
+            std::fprintf(stderr, __VA_ARGS__);                                                 \
+            std::fprintf(stderr, "\n");                                                        \
+            checkFailures()++;                                                                 \
+        }                                                                                      \
+    } while (false)
+
+inline int checkResult()
+{
+    if (checkFailures() == 0)
+        std::printf("all checks passed\n");
+    else
+        std::printf("%d checks failed\n", checkFailures());
+    return checkFailures() == 0 ? 0 : 1;
+}
+
+#endif // CHECK_H
@@ -0,0 +1,117 @@
+// fft and rfft against the direct O(N^2) DFT, for the accuracy bound stated in fft.h
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "check.h"
+#include "../fft.h"
+#include "../threadpool.h"
+
+namespace
+{
+
+// Bound of fft.h, relative to sum(|x[n]|)
+constexpr double BOUND = 1e-14;
+
+std::mt19937 rng(7);
+
+std::vector<std::complex<double>> randomComplex(size_t n)
+{
+    std::uniform_real_distribution<double> value(-1.0, 1.0);
+    std::vector<std::complex<double>> x(n);
+    for (std::complex<double> &v : x)
+        v = {value(rng), value(rng)};
+    return x;
+}
+
+// Direct summation in long double with exactly reduced angles, the reference
+std::vector<std::complex<double>> directDFT(const std::vector<std::complex<double>> &x, bool inverse)
+{
+    const size_t n = x.size();
+    const long double sign = inverse ? 1.0L : -1.0L;
+    std::vector<long double> c(n), s(n);
+    for (size_t m = 0; m < n; m++)
+    {
+        long double angle = sign * 2.0L * static_cast<long double>(M_PI) * m / n;
+        c[m] = std::cos(angle);
+        s[m] = std::sin(angle);
+    }
+
+    std::vector<std::complex<double>> out(n);
+    for (size_t k = 0; k < n; k++)
+    {
+        long double re = 0.0L, im = 0.0L;
+        for (size_t t = 0, m = 0; t < n; t++, m = (m + k) % n)
+        {
+            re += x[t].real() * c[m] - x[t].imag() * s[m];
+            im += x[t].real() * s[m] + x[t].imag() * c[m];
+        }
+        out[k] = {static_cast<double>(re), static_cast<double>(im)};
+    }
+    return out;
+}
+
+// Worst bin error relative to sum(|x[n]|)
+double relativeError(const std::vector<std::complex<double>> &x, const std::vector<std::complex<double>> &reference,
+                     const std::vector<std::complex<double>> &tested)
+{
+    double norm = 0.0, worst = 0.0;
+    for (const std::complex<double> &v : x)
+        norm += std::abs(v);
+    for (size_t k = 0; k < tested.size(); k++)
+        worst = std::max(worst, std::abs(reference[k] - tested[k]));
+    return worst / norm;
+}
+
+void checkLength(size_t n, const char *kind)
+{
+    std::vector<std::complex<double>> x = randomComplex(n);
+
+    for (bool inverse : {false, true})
+    {
+        std::vector<std::complex<double>> y = x;
+        fft(y, inverse);
+        double error = relativeError(x, directDFT(x, inverse), y);
+        CHECK(error < BOUND, "%s fft n %zu%s: %g", kind, n, inverse ? " inverse" : "", error);
+    }
+
+    // Real input: the first n/2+1 bins of the complex transform
+    std::vector<double> real(n);
+    std::vector<std::complex<double>> complexReal(n);
+    for (size_t t = 0; t < n; t++)
+        complexReal[t] = real[t] = x[t].real();
+    std::vector<std::complex<double>> half = rfft(real);
+    CHECK(half.size() == n / 2 + 1, "%s rfft n %zu: %zu bins", kind, n, half.size());
+    double error = relativeError(complexReal, directDFT(complexReal, false), half);
+    CHECK(error < BOUND, "%s rfft n %zu: %g", kind, n, error);
+}
+
+} // namespace
+
+int main()
+{
+    // Four-step needs pool workers, set before the pool starts
+    setenv("ELKAVOLK_THREADS", "4", 1);
+
+    for (size_t n : {1, 2, 4, 8, 64, 256, 1024, 2048})
+        checkLength(n, "power of two");
+    for (size_t n : {3, 5, 6, 7, 12, 100, 441, 1000, 1155, 3003})
+        checkLength(n, "mixed radix");
+    for (size_t n : {17, 127, 251, 1009, 2 * 1031})
+        checkLength(n, "Bluestein");
+
+    // Four-step above the parallel threshold, lowered so that the direct sum stays affordable
+    CHECK(ThreadPool::shared().size() > 0, "no pool workers, four-step not exercised");
+    size_t threshold = FFTPlan::parallelThreshold();
+    FFTPlan::setParallelThreshold(256);
+    for (size_t n : {512, 1024, 1500})
+        checkLength(n, "four-step");
+    // Bluestein lengths run their padded transforms as four-step
+    checkLength(257, "four-step Bluestein");
+    FFTPlan::setParallelThreshold(threshold);
+
+    return checkResult();
+}
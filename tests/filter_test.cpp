@@ -0,0 +1,139 @@
+// Butterworth designs at their cutoffs, the IIR cascade against its response, and convolve()'s
+// partitioned overlap-save against the direct sum
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <random>
+#include <vector>
+
+#include "check.h"
+#include "../filter.h"
+
+namespace
+{
+
+constexpr double SAMPLE_RATE = 44100.0;
+
+// 20*log10(1/sqrt(2)), the Butterworth gain at the cutoff for every order
+const double HALF_POWER_DB = -10.0 * std::log10(2.0);
+
+std::mt19937 rng(5);
+
+std::vector<double> randomValues(size_t n)
+{
+    std::uniform_real_distribution<double> value(-1.0, 1.0);
+    std::vector<double> x(n);
+    for (double &v : x)
+        v = value(rng);
+    return x;
+}
+
+double gainDb(const Filter &filter, double frequency)
+{
+    return 20.0 * std::log10(std::abs(filter.response(frequency)));
+}
+
+void checkButterworth(FilterType type, size_t order)
+{
+    FilterSpec spec;
+    spec.design = FilterDesign::IIR;
+    spec.type = type;
+    spec.low = 1000.0;
+    spec.order = order;
+    Filter filter(spec, SAMPLE_RATE);
+    const char *name = type == FilterType::LowPass ? "low-pass" : "high-pass";
+
+    CHECK(filter.sections().size() == (order + 1) / 2, "%s order %zu: %zu sections", name, order,
+          filter.sections().size());
+    double cutoff = gainDb(filter, spec.low);
+    CHECK(std::abs(cutoff - HALF_POWER_DB) < 1e-9, "%s order %zu: %g dB at the cutoff", name, order, cutoff);
+
+    // Maximally flat: an octave into the pass band stays within the -3 dB of the cutoff,
+    // and the stop band falls off at about 6 dB per octave and order
+    bool lowPass = type == FilterType::LowPass;
+    double pass = gainDb(filter, lowPass ? 500.0 : 2000.0);
+    CHECK(pass > HALF_POWER_DB && pass <= 1e-9, "%s order %zu: %g dB an octave into the pass band", name, order,
+          pass);
+    double stop = gainDb(filter, lowPass ? 4000.0 : 250.0);
+    CHECK(stop < -10.0 * order, "%s order %zu: %g dB two octaves into the stop band", name, order, stop);
+}
+
+// Filter::apply on an impulse gives the impulse response, whose DFT must be response()
+void checkImpulseResponse(size_t order)
+{
+    FilterSpec spec;
+    spec.design = FilterDesign::IIR;
+    spec.type = FilterType::BandPass;
+    spec.low = 500.0;
+    spec.high = 3000.0;
+    spec.order = order;
+    Filter filter(spec, SAMPLE_RATE);
+
+    // Long enough for the response to have died out, split over several blocks of apply()
+    const size_t count = 200000;
+    std::vector<double> impulse(count, 0.0), out(count);
+    impulse[0] = 1.0;
+    filter.apply(impulse.data(), out.data(), count);
+
+    double worst = 0.0;
+    for (double frequency : {100.0, 500.0, 1200.0, 3000.0, 8000.0})
+    {
+        std::complex<double> sum = 0.0;
+        for (size_t n = 0; n < count; n++)
+            sum += out[n] * std::polar(1.0, -2.0 * M_PI * frequency * n / SAMPLE_RATE);
+        worst = std::max(worst, std::abs(sum - filter.response(frequency)));
+    }
+    CHECK(worst < 1e-9, "band-pass order %zu: impulse response off response() by %g", order, worst);
+}
+
+void checkConvolve(size_t count, size_t taps)
+{
+    std::vector<double> in = randomValues(count), kernel = randomValues(taps);
+    std::vector<double> out(count), direct(count, 0.0);
+    convolve(in.data(), count, kernel.data(), taps, out.data());
+    for (size_t n = 0; n < count; n++)
+        for (size_t m = 0; m <= n && m < taps; m++)
+            direct[n] += kernel[m] * in[n - m];
+
+    double worst = 0.0;
+    for (size_t n = 0; n < count; n++)
+        worst = std::max(worst, std::abs(out[n] - direct[n]));
+    // Each output is a sum of taps products of values below 1
+    CHECK(worst < 1e-12 * taps, "convolve %zu samples, %zu taps: %g", count, taps, worst);
+}
+
+} // namespace
+
+int main()
+{
+    for (size_t order = 1; order <= MAX_IIR_ORDER; order++)
+    {
+        checkButterworth(FilterType::LowPass, order);
+        checkButterworth(FilterType::HighPass, order);
+    }
+    for (size_t order : {1, 3, 4})
+        checkImpulseResponse(order);
+
+    // Orders past the limit are clamped
+    FilterSpec spec;
+    spec.design = FilterDesign::IIR;
+    spec.order = 100;
+    CHECK(Filter(spec, SAMPLE_RATE).sections().size() == MAX_IIR_ORDER / 2, "order 100 not clamped");
+
+    // Direct kernels, one partition, several partitions with a short last one, input
+    // shorter than the kernel and not a multiple of the block
+    checkConvolve(1000, 33);
+    checkConvolve(5000, 200);
+    checkConvolve(20000, 4096);
+    checkConvolve(20000, 9000);
+    checkConvolve(3000, 9000);
+    checkConvolve(12345, 5000);
+
+    // A cancelled convolution stops before the first block
+    std::atomic<bool> cancel{true};
+    std::vector<double> in = randomValues(10000), kernel = randomValues(500), out(10000, 7.0);
+    convolve(in.data(), in.size(), kernel.data(), kernel.size(), out.data(), &cancel);
+    CHECK(out[0] == 7.0, "cancelled convolve wrote its output");
+
+    return checkResult();
+}
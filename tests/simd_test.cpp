@@ -0,0 +1,163 @@
+// Every SIMD table the CPU supports against the scalar reference kernels, on random input
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "check.h"
+#include "../simd.h"
+
+namespace
+{
+
+std::mt19937 rng(42);
+
+std::vector<double> randomValues(size_t n)
+{
+    std::uniform_real_distribution<double> value(-1.0, 1.0);
+    std::vector<double> x(n);
+    for (double &v : x)
+        v = value(rng);
+    return x;
+}
+
+std::vector<std::complex<double>> randomComplex(size_t n)
+{
+    std::vector<double> x = randomValues(2 * n);
+    std::vector<std::complex<double>> z(n);
+    for (size_t k = 0; k < n; k++)
+        z[k] = {x[2 * k], x[2 * k + 1]};
+    return z;
+}
+
+// Largest difference, relative to the largest reference value. Fused multiply-adds
+// round once instead of twice, so the tables agree to rounding, not bit for bit
+double difference(const std::vector<double> &reference, const std::vector<double> &tested)
+{
+    if (reference.size() != tested.size())
+        return INFINITY;
+    double worst = 0.0, scale = 1e-300;
+    for (size_t k = 0; k < reference.size(); k++)
+    {
+        worst = std::max(worst, std::abs(reference[k] - tested[k]));
+        scale = std::max(scale, std::abs(reference[k]));
+    }
+    return worst / scale;
+}
+
+std::vector<double> flatten(const std::vector<std::complex<double>> &z)
+{
+    std::vector<double> x;
+    for (const std::complex<double> &v : z)
+    {
+        x.push_back(v.real());
+        x.push_back(v.imag());
+    }
+    return x;
+}
+
+constexpr double TOLERANCE = 1e-14;
+
+// Transform lengths prev both below and above the vector widths, so both the vector
+// loop and the scalar tail of each stage run
+const size_t PREVS[] = {1, 2, 3, 4, 5, 8, 12, 16, 33, 64};
+
+// Lengths of the element-wise kernels, every tail length of an 8-wide vector
+const size_t LENGTHS[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 15, 16, 17, 31, 64, 100, 1023};
+
+void checkRadix2(const SimdKernels &reference, const SimdKernels &tested)
+{
+    for (size_t prev : PREVS)
+    {
+        const size_t n = 2 * prev * 3;
+        std::vector<double> re = randomValues(n), im = randomValues(n);
+        std::vector<double> twRe = randomValues(prev), twIm = randomValues(prev);
+        std::vector<double> re2 = re, im2 = im;
+        reference.radix2Stage(re.data(), im.data(), n, prev, twRe.data(), twIm.data());
+        tested.radix2Stage(re2.data(), im2.data(), n, prev, twRe.data(), twIm.data());
+        double error = std::max(difference(re, re2), difference(im, im2));
+        CHECK(error < TOLERANCE, "%s radix2Stage prev %zu: %g", tested.name, prev, error);
+    }
+}
+
+void checkRadix4(const SimdKernels &reference, const SimdKernels &tested)
+{
+    for (size_t prev : PREVS)
+    {
+        for (double sign : {-1.0, 1.0})
+        {
+            const size_t n = 4 * prev * 3;
+            std::vector<double> re = randomValues(n), im = randomValues(n);
+            std::vector<double> twRe = randomValues(3 * prev), twIm = randomValues(3 * prev);
+            std::vector<double> re2 = re, im2 = im;
+            reference.radix4Stage(re.data(), im.data(), n, prev, twRe.data(), twIm.data(), sign);
+            tested.radix4Stage(re2.data(), im2.data(), n, prev, twRe.data(), twIm.data(), sign);
+            double error = std::max(difference(re, re2), difference(im, im2));
+            CHECK(error < TOLERANCE, "%s radix4Stage prev %zu sign %g: %g", tested.name, prev, sign, error);
+        }
+    }
+}
+
+void checkElementwise(const SimdKernels &reference, const SimdKernels &tested)
+{
+    for (size_t n : LENGTHS)
+    {
+        std::vector<double> re = randomValues(n), im = randomValues(n);
+        std::vector<double> expected(n), actual(n);
+        reference.magnitude(re.data(), im.data(), expected.data(), n);
+        tested.magnitude(re.data(), im.data(), actual.data(), n);
+        double error = difference(expected, actual);
+        CHECK(error < TOLERANCE, "%s magnitude n %zu: %g", tested.name, n, error);
+
+        std::vector<std::complex<double>> z = randomComplex(n);
+        reference.magnitudeInterleaved(z.data(), expected.data(), n);
+        tested.magnitudeInterleaved(z.data(), actual.data(), n);
+        error = difference(expected, actual);
+        CHECK(error < TOLERANCE, "%s magnitudeInterleaved n %zu: %g", tested.name, n, error);
+
+        std::vector<std::complex<double>> a = randomComplex(n), b = randomComplex(n), a2 = a;
+        reference.complexMultiplyInterleaved(a.data(), b.data(), n);
+        tested.complexMultiplyInterleaved(a2.data(), b.data(), n);
+        error = difference(flatten(a), flatten(a2));
+        CHECK(error < TOLERANCE, "%s complexMultiplyInterleaved n %zu: %g", tested.name, n, error);
+
+        std::vector<double> sum = randomValues(n);
+        std::vector<double> sum2 = sum;
+        reference.accumulatePowerInterleaved(z.data(), sum.data(), n);
+        tested.accumulatePowerInterleaved(z.data(), sum2.data(), n);
+        error = difference(sum, sum2);
+        CHECK(error < TOLERANCE, "%s accumulatePowerInterleaved n %zu: %g", tested.name, n, error);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    const SimdKernels &reference = scalarKernels();
+
+    // The scalar kernels themselves against the definitions
+    std::vector<std::complex<double>> a = randomComplex(5), b = randomComplex(5), product = a;
+    std::vector<double> power(5, 1.0), magnitude(5);
+    reference.complexMultiplyInterleaved(product.data(), b.data(), 5);
+    reference.accumulatePowerInterleaved(a.data(), power.data(), 5);
+    reference.magnitudeInterleaved(a.data(), magnitude.data(), 5);
+    for (size_t k = 0; k < 5; k++)
+    {
+        CHECK(std::abs(product[k] - a[k] * b[k]) < 1e-15, "scalar complexMultiplyInterleaved %zu", k);
+        CHECK(std::abs(power[k] - (1.0 + std::norm(a[k]))) < 1e-15, "scalar accumulatePowerInterleaved %zu", k);
+        CHECK(std::abs(magnitude[k] - std::abs(a[k])) < 1e-15, "scalar magnitudeInterleaved %zu", k);
+    }
+
+    for (const SimdKernels *tested : supportedKernels())
+    {
+        std::printf("checking %s\n", tested->name);
+        checkRadix2(reference, *tested);
+        checkRadix4(reference, *tested);
+        checkElementwise(reference, *tested);
+    }
+
+    return checkResult();
+}
@@ -0,0 +1,119 @@
+// realDFT and mirrorSpectrum (Signal::getRealDFT / getDFT) against the direct DFT, and the
+// sine amplitude scale of the charts and batch files
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <random>
+#include <vector>
+
+#include "check.h"
+#include "../spectrum.h"
+
+namespace
+{
+
+// X[k] = sum x[t] * w[t] * exp(-2*pi*i * k*t / length), x zero past its end
+std::complex<double> directBin(const std::vector<double> &x, const std::vector<double> &w, size_t length, size_t k)
+{
+    std::complex<double> sum = 0.0;
+    for (size_t t = 0; t < std::min(x.size(), length); t++)
+    {
+        double angle = -2.0 * M_PI * static_cast<double>((k * t) % length) / static_cast<double>(length);
+        sum += x[t] * w[t] * std::polar(1.0, angle);
+    }
+    return sum;
+}
+
+std::vector<double> randomSamples(size_t count, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> value(-1.0, 1.0);
+    std::vector<double> x(count);
+    for (double &v : x)
+        v = value(rng);
+    return x;
+}
+
+// Worst bin error of realDFT(x, length, window), the window spanning the samples only
+double realDFTError(const std::vector<double> &x, size_t length, WindowType window)
+{
+    const size_t count = std::min(x.size(), length);
+    std::vector<double> w(x.size(), 1.0);
+    std::shared_ptr<const Window> table = Window::get(window, count);
+    for (size_t t = 0; t < count; t++)
+        w[t] = (*table)[t];
+
+    std::vector<std::complex<double>> half = realDFT(x, length, window);
+    if (half.size() != length / 2 + 1)
+        return INFINITY;
+    double worst = 0.0;
+    for (size_t k = 0; k < half.size(); k++)
+        worst = std::max(worst, std::abs(half[k] - directBin(x, w, length, k)));
+    return worst;
+}
+
+void checkRealDFT(size_t count, size_t length, WindowType window, unsigned seed)
+{
+    double error = realDFTError(randomSamples(count, seed), length, window);
+    CHECK(error < 1e-12 * length, "%zu samples over %zu points, window %d: error %g", count, length,
+          static_cast<int>(window), error);
+}
+
+// A offset, a sine and a Nyquist tone read back their own amplitudes in their bins
+void checkSineAmplitudes(size_t length, WindowType window)
+{
+    const double offset = 0.25, amplitude = 0.7, nyquist = 0.1;
+    const size_t bin = length / 8;
+    std::vector<double> x(length);
+    for (size_t t = 0; t < length; t++)
+        x[t] = offset + amplitude * std::cos(2.0 * M_PI * static_cast<double>(bin * t) / length + 0.3) +
+               (t % 2 ? -nyquist : nyquist);
+
+    std::vector<double> amplitudes = sineAmplitudes(realDFT(x, length, window), length,
+                                                    sineAmplitudeScale(length, window));
+    CHECK(amplitudes.size() == length / 2 + 1, "%zu amplitudes for %zu points", amplitudes.size(), length);
+    if (amplitudes.size() != length / 2 + 1)
+        return;
+    // The window's own sidelobes at the neighbouring tones stay far below these
+    CHECK(std::abs(amplitudes[0] - offset) < 1e-3, "window %d: DC %g", static_cast<int>(window), amplitudes[0]);
+    CHECK(std::abs(amplitudes[bin] - amplitude) < 1e-12, "window %d: sine %g", static_cast<int>(window),
+          amplitudes[bin]);
+    CHECK(std::abs(amplitudes.back() - nyquist) < 1e-3, "window %d: Nyquist %g", static_cast<int>(window),
+          amplitudes.back());
+}
+
+} // namespace
+
+int main()
+{
+    // Full length, zero-padded (window over the samples only) and cut
+    checkRealDFT(1000, 1000, WindowType::Rectangular, 1);
+    checkRealDFT(441, 441, WindowType::Hann, 2);
+    checkRealDFT(300, 1000, WindowType::Rectangular, 3);
+    checkRealDFT(300, 1000, WindowType::BlackmanHarris, 4);
+    checkRealDFT(2500, 1000, WindowType::Rectangular, 5);
+    checkRealDFT(2500, 1000, WindowType::Kaiser, 6);
+
+    CHECK(realDFT({}, 1000).empty(), "no samples");
+    CHECK(realDFT(randomSamples(10, 7), 0).empty(), "zero length");
+
+    // The mirrored upper half completes the direct DFT, even and odd lengths
+    for (size_t length : {1000u, 441u})
+    {
+        std::vector<double> x = randomSamples(length, 8);
+        std::vector<double> w(length, 1.0);
+        std::vector<std::complex<double>> full = mirrorSpectrum(realDFT(x, length), length);
+        CHECK(full.size() == length, "mirrored size %zu for %zu", full.size(), length);
+        double worst = 0.0;
+        for (size_t k = 0; k < full.size(); k++)
+            worst = std::max(worst, std::abs(full[k] - directBin(x, w, length, k)));
+        CHECK(worst < 1e-12 * length, "mirrored %zu points: error %g", length, worst);
+    }
+
+    checkSineAmplitudes(1024, WindowType::Rectangular);
+    checkSineAmplitudes(1024, WindowType::Hann);
+    checkSineAmplitudes(1000, WindowType::BlackmanHarris);
+    CHECK(sineAmplitudeScale(0, WindowType::Hann) == 0.0, "empty window");
+
+    return checkResult();
+}
@@ -0,0 +1,129 @@
+// synthesize against exact cosine sums and OvertoneBank::value, whole and in chunks
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "check.h"
+#include "../synth.h"
+
+namespace
+{
+
+constexpr double SAMPLE_RATE = 44100.0;
+
+std::mt19937 rng(11);
+
+// Tones across the audible range at random phases
+OvertoneBank randomBank(size_t tones)
+{
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    OvertoneBank bank;
+    for (size_t k = 0; k < tones; k++)
+        bank.add(unit(rng), 20.0 + 20000.0 * unit(rng), 2.0 * M_PI * unit(rng));
+    return bank;
+}
+
+double amplitudeSum(const OvertoneBank &bank)
+{
+    double sum = 0.0;
+    for (double a : bank.amplitude)
+        sum += std::abs(a);
+    return sum;
+}
+
+// Sum of the tones at sample n, the phase reduced to one period in long double
+long double exactValue(const OvertoneBank &bank, size_t n)
+{
+    long double value = 0.0L;
+    for (size_t k = 0; k < bank.size(); k++)
+    {
+        long double cycles = static_cast<long double>(bank.frequency[k]) * n / SAMPLE_RATE;
+        cycles -= std::floor(cycles);
+        value += bank.amplitude[k] * std::cos(2.0L * static_cast<long double>(M_PI) * cycles + bank.phase[k]);
+    }
+    return value;
+}
+
+void checkAccuracy(size_t tones, double seconds)
+{
+    const OvertoneBank bank = randomBank(tones);
+    const size_t count = static_cast<size_t>(seconds * SAMPLE_RATE);
+    std::vector<double> out(count);
+    synthesize(bank, SAMPLE_RATE, 0, count, out.data());
+
+    // Bound of synth.h against the exact sum
+    const double scale = amplitudeSum(bank);
+    double exactError = 0.0;
+    for (size_t n = 0; n < count; n += 13)
+        exactError = std::max(exactError, static_cast<double>(std::abs(exactValue(bank, n) - out[n])));
+    CHECK(exactError < 1e-12 * scale, "%zu tones over %g s: %g of sum(|a|) from the exact sum", tones, seconds,
+          exactError / scale);
+
+    // OvertoneBank::value rounds 2*pi*f*t itself, each tone may be off by about 1e-16 of its argument
+    for (size_t n = 0; n < count; n += 13)
+    {
+        const double time = n / SAMPLE_RATE;
+        double allowed = 1e-12 * scale;
+        for (size_t k = 0; k < bank.size(); k++)
+            allowed += 4e-16 * (2.0 * M_PI * bank.frequency[k] * time + std::abs(bank.phase[k])) * bank.amplitude[k];
+        double error = std::abs(bank.value(time) - out[n]);
+        if (error > allowed)
+        {
+            CHECK(error <= allowed, "%zu tones, sample %zu: %g from OvertoneBank::value, %g allowed", tones, n,
+                  error, allowed);
+            break;
+        }
+    }
+}
+
+// Difference between the same samples synthesized in chunks and in one call
+double chunkDifference(const OvertoneBank &bank, size_t begin, size_t count, size_t maxChunk, size_t alignment)
+{
+    std::vector<double> whole(count), chunked(count);
+    synthesize(bank, SAMPLE_RATE, begin, begin + count, whole.data());
+
+    std::uniform_int_distribution<size_t> length(1, maxChunk);
+    for (size_t done = 0; done < count;)
+    {
+        size_t end = std::min(count, done + length(rng) * alignment);
+        synthesize(bank, SAMPLE_RATE, begin + done, begin + end, chunked.data() + done);
+        done = end;
+    }
+
+    double worst = 0.0;
+    for (size_t n = 0; n < count; n++)
+        worst = std::max(worst, std::abs(whole[n] - chunked[n]));
+    return worst;
+}
+
+void checkChunks()
+{
+    const OvertoneBank bank = randomBank(7);
+
+    // Chunks on SYNTH_BLOCK boundaries are seeded where one call seeds, the samples are identical
+    double aligned = chunkDifference(bank, 10 * SYNTH_BLOCK, 40 * SYNTH_BLOCK, 5, SYNTH_BLOCK);
+    CHECK(aligned == 0.0, "chunks on block boundaries differ by %g", aligned);
+
+    // Other chunks are seeded exactly at their first sample, they agree to the accuracy bound
+    double scale = amplitudeSum(bank);
+    double unaligned = chunkDifference(bank, 123457, 20000, 3000, 1);
+    CHECK(unaligned < 1e-12 * scale, "chunks at any sample differ by %g of sum(|a|)", unaligned / scale);
+}
+
+} // namespace
+
+int main()
+{
+    checkAccuracy(1, 10.0);
+    checkAccuracy(50, 10.0);
+    checkAccuracy(200, 1.0);
+    checkChunks();
+
+    // Nothing to synthesize
+    std::vector<double> out(16, 1.0);
+    synthesize(OvertoneBank(), SAMPLE_RATE, 0, out.size(), out.data());
+    CHECK(std::all_of(out.begin(), out.end(), [](double v) { return v == 0.0; }), "empty bank is not silent");
+
+    return checkResult();
+}
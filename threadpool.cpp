@@ -0,0 +1,151 @@
+#include "threadpool.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace
+{
+
+// Pool and queue index of the worker running on this thread
+thread_local const ThreadPool *currentPool = nullptr;
+thread_local int currentWorker = -1;
+
+} // namespace
+
+ThreadPool &ThreadPool::shared()
+{
+    // The calling thread also works, so one worker less than the number of threads
+    static ThreadPool pool([] {
+        size_t threads = std::thread::hardware_concurrency();
+        if (const char *forced = std::getenv("ELKAVOLK_THREADS"))
+            threads = std::strtoul(forced, nullptr, 10);
+        return std::max<size_t>(threads, 1) - 1;
+    }());
+    return pool;
+}
+
+ThreadPool::ThreadPool(size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        queues.push_back(std::make_unique<Queue>());
+    for (size_t i = 0; i < count; i++)
+        threads.emplace_back(&ThreadPool::workerLoop, this, static_cast<int>(i));
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread &thread : threads)
+        thread.join();
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    if (threads.empty())
+    {
+        task();
+        return;
+    }
+
+    // Workers push to their own deque, other threads spread tasks round-robin
+    // (counted before it is visible so that the counter never goes below zero)
+    size_t index = currentPool == this ? currentWorker : nextQueue++ % queues.size();
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        queued++;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    wake.notify_one();
+}
+
+bool ThreadPool::runOne(int self)
+{
+    std::function<void()> task;
+
+    if (self >= 0)
+    {
+        Queue &own = *queues[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty())
+        {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+        }
+    }
+
+    // Steal the oldest task of another queue
+    for (size_t i = 0; !task && i < queues.size(); i++)
+    {
+        size_t victim = (static_cast<size_t>(self + 1) + i) % queues.size();
+        Queue &other = *queues[victim];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.tasks.empty())
+        {
+            task = std::move(other.tasks.front());
+            other.tasks.pop_front();
+        }
+    }
+
+    if (!task)
+        return false;
+    queued--;
+    task();
+    return true;
+}
+
+void ThreadPool::workerLoop(int self)
+{
+    currentPool = this;
+    currentWorker = self;
+    for (;;)
+    {
+        if (runOne(self))
+            continue;
+
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        wake.wait(lock, [this] { return stopping || queued > 0; });
+        if (stopping)
+            return;
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t, size_t)> &body, size_t grain)
+{
+    if (count == 0)
+        return;
+
+    // A few chunks per thread so that stealing can even out the load
+    size_t chunks = std::min((threads.size() + 1) * 4, (count + grain - 1) / std::max<size_t>(grain, 1));
+    if (threads.empty() || chunks <= 1)
+    {
+        body(0, count);
+        return;
+    }
+
+    size_t step = (count + chunks - 1) / chunks;
+    std::atomic<size_t> remaining{0};
+    for (size_t begin = step; begin < count; begin += step)
+    {
+        size_t end = std::min(count, begin + step);
+        remaining++;
+        submit([&body, &remaining, begin, end] {
+            body(begin, end);
+            remaining--;
+        });
+    }
+
+    // Do the first chunk here, then help with whatever is queued until every chunk is done
+    body(0, std::min(count, step));
+    int self = currentPool == this ? currentWorker : -1;
+    while (remaining > 0)
+    {
+        if (!runOne(self))
+            std::this_thread::yield();
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing thread pool.
+// Every worker owns a task deque: it pops its own tasks from the back and, when it runs dry,
+// steals from the front of the other deques. Threads that wait in parallelFor run queued
+// tasks themselves, so parallel sections can be nested without deadlocking the pool. Any of
+// those tasks may run on a thread in the middle of a parallelFor: per-thread buffers held
+// across one must come from ScratchBuffer (scratch.h), not a plain thread_local.
+class ThreadPool
+{
+public:
+    // Process-wide pool shared by every caller, sized to the hardware threads
+    // (ELKAVOLK_THREADS in the environment overrides the thread count)
+    static ThreadPool &shared();
+
+    explicit ThreadPool(size_t threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // Number of worker threads (0 means everything runs on the calling thread)
+    size_t size() const { return threads.size(); }
+
+    // Queue a task
+    void submit(std::function<void()> task);
+
+    // Call body(begin, end) over [0, count) split into chunks of at least grain items,
+    // return when every chunk is done. The calling thread takes part in the work.
+    void parallelFor(size_t count, const std::function<void(size_t, size_t)> &body, size_t grain = 1);
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    // Run one queued task, preferring the queue of worker self (-1 for outside threads)
+    bool runOne(int self);
+    void workerLoop(int self);
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::atomic<size_t> queued{0};
+    std::atomic<size_t> nextQueue{0};
+    bool stopping = false;
+};
+
+#endif // THREADPOOL_H
@@ -0,0 +1,43 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+#include <atomic>
+
+// Single-writer, single-reader handoff of the latest value, wait-free on both sides.
+// Three slots rotate between the writer (back), the reader (front) and a middle slot
+// exchanged atomically; the reader always gets the newest published value and older
+// unread values are simply overwritten. Nothing is allocated after construction.
+template <class T>
+class TripleBuffer
+{
+public:
+    // Writer: fill this slot, then publish() it
+    T &writeBuffer() { return slots[back]; }
+
+    void publish()
+    {
+        back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX;
+    }
+
+    // Reader: take the newest published value, return false if nothing new was published
+    bool update()
+    {
+        if (!(middle.load(std::memory_order_acquire) & FRESH))
+            return false;
+        front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+
+    // Reader: value taken by the last successful update()
+    const T &read() const { return slots[front]; }
+
+private:
+    static constexpr int INDEX = 3;
+    static constexpr int FRESH = 4; // Set in middle when it holds an unread value
+
+    T slots[3];
+    int back = 0;
+    std::atomic<int> middle{1};
+    int front = 2;
+};
+
+#endif // TRIPLEBUFFER_H
@@ -0,0 +1,79 @@
+#include "welch.h"
+#include "fft.h"
+#include "simd.h"
+#include <algorithm>
+#include <cmath>
+
+WelchEstimator::WelchEstimator(size_t segmentSize, size_t hop, WindowType type, double sampleRate)
+    : segmentSize(segmentSize), hop(std::clamp<size_t>(hop, 1, std::max<size_t>(segmentSize, 1))),
+      sampleRate(sampleRate)
+{
+    if (segmentSize == 0)
+        return;
+    window = Window::get(type, segmentSize);
+    plan = RealFFTPlan::get(segmentSize);
+    segment.resize(segmentSize);
+    spectrum.resize(plan->bins());
+    sum.assign(plan->bins(), 0.0);
+}
+
+void WelchEstimator::add(const double *samples, size_t count, const std::atomic<bool> *cancel)
+{
+    if (segmentSize == 0)
+        return;
+
+    while (count > 0)
+    {
+        size_t take = std::min(count, segmentSize - filled);
+        std::copy(samples, samples + take, segment.begin() + filled);
+        filled += take;
+        samples += take;
+        count -= take;
+
+        if (filled == segmentSize)
+        {
+            if (cancel && *cancel)
+                return;
+            processSegment();
+            // Keep the overlap with the next segment
+            std::copy(segment.begin() + hop, segment.end(), segment.begin());
+            filled = segmentSize - hop;
+        }
+    }
+}
+
+void WelchEstimator::processSegment()
+{
+    plan->execute(segment.data(), spectrum.data(), window->data());
+    simdKernels().accumulatePowerInterleaved(spectrum.data(), sum.data(), spectrum.size());
+    segmentCount++;
+}
+
+std::vector<double> WelchEstimator::psd() const
+{
+    if (segmentCount == 0)
+        return {};
+
+    // Periodogram scaling by the window energy, so the estimate does not depend on the window
+    double energy = 0.0;
+    for (size_t i = 0; i < segmentSize; i++)
+        energy += (*window)[i] * (*window)[i];
+    const double scale = 1.0 / (sampleRate * energy * segmentCount);
+
+    std::vector<double> result(sum.size());
+    for (size_t k = 0; k < sum.size(); k++)
+    {
+        // One-sided: the mirrored half is folded in, except at DC and Nyquist
+        bool single = k == 0 || 2 * k == segmentSize;
+        result[k] = sum[k] * scale * (single ? 1.0 : 2.0);
+    }
+    return result;
+}
+
+std::vector<double> powerToDb(const std::vector<double> &power, double floorDb)
+{
+    std::vector<double> db(power.size());
+    for (size_t k = 0; k < power.size(); k++)
+        db[k] = power[k] > 0 ? std::max(floorDb, 10.0 * std::log10(power[k])) : floorDb;
+    return db;
+}
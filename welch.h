@@ -0,0 +1,57 @@
+#ifndef WELCH_H
+#define WELCH_H
+#include <atomic>
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "window.h"
+
+class RealFFTPlan;
+
+// Welch's power spectral density estimate, accumulated as samples stream in.
+// The input is cut into overlapping windowed segments, the periodograms of the segments are
+// averaged, which trades frequency resolution (sampleRate / segmentSize) for a much less noisy
+// estimate than one long DFT. Only one segment is kept in memory, however long the input.
+// https://en.wikipedia.org/wiki/Welch%27s_method
+class WelchEstimator
+{
+public:
+    // Segments of segmentSize samples starting every hop samples (hop <= segmentSize)
+    WelchEstimator(size_t segmentSize, size_t hop, WindowType window, double sampleRate);
+
+    // Feed the next count samples, any chunk size. Returns before the next segment once
+    // cancel becomes true, the estimate is then incomplete
+    void add(const double *samples, size_t count, const std::atomic<bool> *cancel = nullptr);
+
+    // Number of segments averaged so far
+    size_t segments() const { return segmentCount; }
+    size_t bins() const { return sum.size(); }
+    // Width of a bin in Hz
+    double binWidth() const { return sampleRate / segmentSize; }
+
+    // One-sided PSD in units^2/Hz for bins 0..segmentSize/2 (empty before the first segment).
+    // A sine of amplitude A adds A^2/2 to the integral of the PSD over its peak
+    std::vector<double> psd() const;
+
+private:
+    void processSegment();
+
+    size_t segmentSize;
+    size_t hop;
+    double sampleRate;
+    std::shared_ptr<const Window> window;
+    std::shared_ptr<const RealFFTPlan> plan;
+
+    std::vector<double> segment; // Samples of the segment being filled
+    size_t filled = 0;
+    std::vector<std::complex<double>> spectrum;
+    std::vector<double> sum;     // Sum of |X[k]|^2 over the segments
+    size_t segmentCount = 0;
+};
+
+// Power in decibels, 10 * log10(power), with a floor instead of -infinity
+std::vector<double> powerToDb(const std::vector<double> &power, double floorDb = -300.0);
+
+#endif // WELCH_H
@@ -0,0 +1,87 @@
+#include "window.h"
+#include "sharedcache.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+constexpr double KAISER_BETA = 8.6;
+
+SharedCache<std::pair<WindowType, size_t>, Window> cache(32);
+
+// Modified Bessel function of the first kind, order 0, by its power series
+double besselI0(double x)
+{
+    double sum = 1.0, term = 1.0;
+    const double quarter = x * x / 4.0;
+    for (int k = 1; k < 100 && term > 1e-17 * sum; k++)
+    {
+        term *= quarter / (static_cast<double>(k) * k);
+        sum += term;
+    }
+    return sum;
+}
+
+// Sum of cosines a0 - a1 cos(x) + a2 cos(2x) - a3 cos(3x), x = 2*pi*i/n
+double cosineSum(const double *a, size_t terms, size_t i, size_t n)
+{
+    double x = 2.0 * M_PI * static_cast<double>(i) / static_cast<double>(n);
+    double value = 0.0, sign = 1.0;
+    for (size_t k = 0; k < terms; k++, sign = -sign)
+        value += sign * a[k] * std::cos(k * x);
+    return value;
+}
+
+} // namespace
+
+std::shared_ptr<const Window> Window::get(WindowType type, size_t n)
+{
+    return cache.get({type, n}, [=] { return std::make_shared<const Window>(type, n); });
+}
+
+void Window::clearCache()
+{
+    cache.clear();
+}
+
+Window::Window(WindowType type, size_t n)
+    : windowType(type), coefficients(n, 1.0)
+{
+    if (n == 0)
+        return;
+
+    static const double hann[] = {0.5, 0.5};
+    static const double hamming[] = {0.54, 0.46};
+    static const double blackmanHarris[] = {0.35875, 0.48829, 0.14128, 0.01168};
+
+    for (size_t i = 0; i < n; i++)
+    {
+        switch (type)
+        {
+        case WindowType::Rectangular:
+            break;
+        case WindowType::Hann:
+            coefficients[i] = cosineSum(hann, 2, i, n);
+            break;
+        case WindowType::Hamming:
+            coefficients[i] = cosineSum(hamming, 2, i, n);
+            break;
+        case WindowType::BlackmanHarris:
+            coefficients[i] = cosineSum(blackmanHarris, 4, i, n);
+            break;
+        case WindowType::Kaiser:
+        {
+            // Periodic: the symmetric window of length n+1 without its last point
+            double r = 2.0 * static_cast<double>(i) / static_cast<double>(n) - 1.0;
+            coefficients[i] = besselI0(KAISER_BETA * std::sqrt(std::max(0.0, 1.0 - r * r))) / besselI0(KAISER_BETA);
+            break;
+        }
+        }
+    }
+
+    double sum = 0.0;
+    for (double w : coefficients)
+        sum += w;
+    gain = sum / static_cast<double>(n);
+}
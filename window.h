@@ -0,0 +1,47 @@
+#ifndef WINDOW_H
+#define WINDOW_H
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Tapers applied to a frame before its DFT to reduce spectral leakage
+// https://en.wikipedia.org/wiki/Window_function
+enum class WindowType
+{
+    Rectangular,    // No taper: narrowest peaks, worst leakage
+    Hann,
+    Hamming,
+    BlackmanHarris, // 4-term, sidelobes below -92 dB
+    Kaiser          // beta = 8.6, close to Blackman-Harris with a tunable shape
+};
+
+// Window coefficients of one type and length.
+// Tables are periodic (DFT-even, w[n] = w[0] is the next frame's first sample), which is what
+// spectral analysis wants, and are shared through a cache like the FFT plans.
+class Window
+{
+public:
+    // Shared table for the given type and length
+    static std::shared_ptr<const Window> get(WindowType type, size_t n);
+
+    // Drop every cached table
+    static void clearCache();
+
+    Window(WindowType type, size_t n);
+
+    WindowType type() const { return windowType; }
+    size_t size() const { return coefficients.size(); }
+    const double *data() const { return coefficients.data(); }
+    double operator[](size_t i) const { return coefficients[i]; }
+
+    // Mean of the coefficients: a sine windowed by this table peaks at
+    // coherentGain * n/2 * amplitude in its bin instead of n/2 * amplitude
+    double coherentGain() const { return gain; }
+
+private:
+    WindowType windowType;
+    std::vector<double> coefficients;
+    double gain = 1.0;
+};
+
+#endif // WINDOW_H